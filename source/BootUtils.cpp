@@ -18,7 +18,7 @@
 #include <sysapp/title.h>
 #include <vector>
 
-void handleAccountSelection();
+void handleAccountSelection(UiSession &session);
 
 void bootWiiUMenu() {
     nn::act::Initialize();
@@ -33,14 +33,15 @@ void bootWiiUMenu() {
     }
 }
 
-void bootHomebrewLauncher() {
-    handleAccountSelection();
+void bootHomebrewLauncher(UiSession &session) {
+    handleAccountSelection(session);
+    session.shutdown();
 
     uint64_t titleId = _SYSGetSystemApplicationTitleId(SYSTEM_APP_ID_MII_MAKER);
     _SYSLaunchTitleWithStdArgsInNoSplash(titleId, nullptr);
 }
 
-void handleAccountSelection() {
+void handleAccountSelection(UiSession &session) {
     nn::act::Initialize();
     nn::act::SlotNo defaultSlot = nn::act::GetDefaultAccount();
 
@@ -76,7 +77,7 @@ void handleAccountSelection() {
             if (!AXIsInit()) {
                 AXInit();
             }
-            auto slot = handleAccountSelectScreen(accountInfoList);
+            auto slot = handleAccountSelectScreen(session, accountInfoList);
 
             DEBUG_FUNCTION_LINE("Load slot %d", slot);
             nn::act::LoadConsoleAccount(slot, 0, nullptr, false);
@@ -1,10 +1,11 @@
 #pragma once
 
+#include "UiSession.h"
 #include <cstdint>
 
 void bootWiiUMenu();
 
-void bootHomebrewLauncher();
+void bootHomebrewLauncher(UiSession &session);
 
 void bootvWiiMenu();
 
@@ -0,0 +1,228 @@
+#include "DisplayList.h"
+#include "logger.h"
+
+// More dirty rectangles than this are merged into one
+#define MAX_DIRTY_RECTS 16
+
+static uint64_t hashBytes(const void *data, size_t size, uint64_t hash) {
+    auto *bytes = (const uint8_t *) data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+void DisplayList::Item::updateHash() {
+    // 64 bit FNV-1a, a collision would only skip the repaint of one item
+    const uint32_t fields[] = {type, x, y, w, h, color.color, align, run.getFontSize()};
+    hash = hashBytes(fields, sizeof(fields), 0xCBF29CE484222325ull);
+    hash = hashBytes(&image, sizeof(image), hash);
+    if (type == ITEM_TEXT) {
+        hash = hashBytes(run.getText().data(), run.getText().size(), hash);
+    }
+}
+
+void DisplayList::setStaticContent(std::function<void()> drawFn) {
+    mStaticDrawFn = std::move(drawFn);
+    mStaticLayer.release();
+    mStaticLayerFailed = false;
+    invalidate();
+}
+
+void DisplayList::beginFrame(Color background) {
+    if (mStaticLayer.isValid() && mStaticLayerBackground.color != background.color) {
+        mStaticLayer.release();
+    }
+    mBackground = background;
+    mItemCount  = 0;
+}
+
+DisplayList::Item &DisplayList::addItem(ItemType type) {
+    // Items are reused between frames to keep their text runs.
+    if (mItemCount == mItems.size()) {
+        mItems.emplace_back();
+    }
+    Item &item  = mItems[mItemCount++];
+    item.type   = type;
+    item.bounds = {};
+    item.x      = 0;
+    item.y      = 0;
+    item.w      = 0;
+    item.h      = 0;
+    item.color  = Color(0);
+    item.align  = TEXT_ALIGN_LEFT;
+    item.image  = nullptr;
+    return item;
+}
+
+void DisplayList::drawRectFilled(uint32_t x, uint32_t y, uint32_t w, uint32_t h, Color col) {
+    Item &item  = addItem(ITEM_RECT_FILLED);
+    item.x      = x;
+    item.y      = y;
+    item.w      = w;
+    item.h      = h;
+    item.color  = col;
+    item.bounds = Rect(x, y, w, h);
+    item.updateHash();
+}
+
+void DisplayList::drawRect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t borderSize, Color col) {
+    if (borderSize * 2 >= w || borderSize * 2 >= h) {
+        drawRectFilled(x, y, w, h, col);
+        return;
+    }
+    // Split into the four borders so only they get repainted when the border changes.
+    drawRectFilled(x, y, w, borderSize, col);
+    drawRectFilled(x, y + h - borderSize, w, borderSize, col);
+    drawRectFilled(x, y + borderSize, borderSize, h - borderSize * 2, col);
+    drawRectFilled(x + w - borderSize, y + borderSize, borderSize, h - borderSize * 2, col);
+}
+
+void DisplayList::print(uint32_t x, uint32_t y, std::string_view text, uint32_t fontSize, Color col, TextAlign align) {
+    Item &item = addItem(ITEM_TEXT);
+    item.x     = x;
+    item.y     = y;
+    item.color = col;
+    item.align = align;
+    item.run.set(text, fontSize);
+    item.bounds = item.run.getBounds(x, y, align);
+    item.updateHash();
+}
+
+void DisplayList::drawImage(uint32_t x, uint32_t y, const DecodedImage &image) {
+    Item &item  = addItem(ITEM_IMAGE);
+    item.x      = x;
+    item.y      = y;
+    item.image  = &image;
+    item.bounds = Rect(x, y, image.getWidth(), image.getHeight());
+    item.updateHash();
+}
+
+template<typename T>
+bool DisplayList::containsHash(const std::vector<T> &items, uint32_t count, uint64_t hash) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (items[i].hash == hash) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DisplayList::drawItem(const Item &item) const {
+    switch (item.type) {
+        case ITEM_RECT_FILLED:
+            DrawUtils::drawRectFilled(item.x, item.y, item.w, item.h, item.color);
+            break;
+        case ITEM_TEXT:
+            DrawUtils::setFontColor(item.color);
+            DrawUtils::print(item.x, item.y, item.run, item.align);
+            break;
+        case ITEM_IMAGE:
+            DrawUtils::drawImage(item.x, item.y, *item.image);
+            break;
+    }
+}
+
+void DisplayList::drawBackground() const {
+    if (mStaticLayer.isValid()) {
+        DrawUtils::drawLayer(mStaticLayer);
+        return;
+    }
+    DrawUtils::clear(mBackground);
+    if (mStaticDrawFn) {
+        mStaticDrawFn();
+    }
+}
+
+void DisplayList::endFrame() {
+    DrawUtils::beginDraw();
+
+    uint32_t target    = DrawUtils::getTargetIndex();
+    auto &drawn        = mDrawn[target];
+    uint32_t drawCount = mDrawnCount[target];
+    bool fullRepaint   = !DrawUtils::claimTarget(this) || !mDrawnValid[target] || mDrawnBackground[target].color != mBackground.color;
+
+    // Everything that was added, removed or changed since the last time we drew into this buffer is dirty.
+    Rect dirty[MAX_DIRTY_RECTS];
+    uint32_t dirtyCount = 0;
+
+    if (fullRepaint) {
+        drawBackground();
+        if (mStaticDrawFn && !mStaticLayer.isValid() && !mStaticLayerFailed) {
+            // without a layer we keep drawing the static content every time
+            mStaticLayerFailed     = !DrawUtils::captureLayer(mStaticLayer);
+            mStaticLayerBackground = mBackground;
+        }
+        for (uint32_t i = 0; i < mItemCount; i++) {
+            drawItem(mItems[i]);
+        }
+    } else {
+        auto addDirty = [&dirty, &dirtyCount](Rect rect) {
+            if (rect.empty()) {
+                return;
+            }
+            // merge with the overlapping rects, the merged rect may overlap others again so start over
+            for (uint32_t i = 0; i < dirtyCount;) {
+                if (dirty[i].intersects(rect)) {
+                    rect     = rect.united(dirty[i]);
+                    dirty[i] = dirty[--dirtyCount];
+                    i        = 0;
+                } else {
+                    i++;
+                }
+            }
+            if (dirtyCount == MAX_DIRTY_RECTS) {
+                for (uint32_t i = 0; i < dirtyCount; i++) {
+                    rect = rect.united(dirty[i]);
+                }
+                dirtyCount = 0;
+            }
+            dirty[dirtyCount++] = rect;
+        };
+        for (uint32_t i = 0; i < mItemCount; i++) {
+            if (!containsHash(drawn, drawCount, mItems[i].hash)) {
+                addDirty(mItems[i].bounds);
+            }
+        }
+        for (uint32_t i = 0; i < drawCount; i++) {
+            if (!containsHash(mItems, mItemCount, drawn[i].hash)) {
+                addDirty(drawn[i].bounds);
+            }
+        }
+
+        for (uint32_t d = 0; d < dirtyCount; d++) {
+            DrawUtils::setClipRect(dirty[d]);
+            drawBackground();
+            for (uint32_t i = 0; i < mItemCount; i++) {
+                if (mItems[i].bounds.intersects(dirty[d])) {
+                    drawItem(mItems[i]);
+                }
+            }
+        }
+        DrawUtils::resetClipRect();
+        DEBUG_FUNCTION_LINE_VERBOSE("Repainted %d dirty rects", dirtyCount);
+    }
+
+    if (fullRepaint) {
+        DrawUtils::endDraw();
+    } else {
+        DrawUtils::endDraw(std::span(dirty, dirtyCount));
+    }
+
+    // Remember what this buffer shows now
+    if (drawn.size() < mItemCount) {
+        drawn.resize(mItemCount);
+    }
+    for (uint32_t i = 0; i < mItemCount; i++) {
+        drawn[i] = {mItems[i].bounds, mItems[i].hash};
+    }
+    mDrawnCount[target]      = mItemCount;
+    mDrawnBackground[target] = mBackground;
+    mDrawnValid[target]      = true;
+}
+
+void DisplayList::invalidate() {
+    for (auto &valid : mDrawnValid) {
+        valid = false;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "DrawUtils.h"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+/**
+ * Retained list of everything a screen draws in a frame.
+ *
+ * Each frame the screen records its items between beginFrame and endFrame. endFrame compares them with the
+ * items that were drawn into the current target buffer last time and only repaints the rectangles that changed.
+ * Items are kept by their index between frames and only a hash of their content is remembered per buffer, so a
+ * frame whose items didn't change doesn't allocate.
+ */
+class DisplayList {
+public:
+    DisplayList() = default;
+
+    DisplayList(const DisplayList &) = delete;
+
+    DisplayList &operator=(const DisplayList &) = delete;
+
+    /**
+     * Sets the parts of the screen that never change while it's open. They are drawn once on top of the
+     * background, captured into a layer and afterwards restored with a bulk copy instead of being drawn again.
+     */
+    void setStaticContent(std::function<void()> drawFn);
+
+    void beginFrame(Color background);
+
+    void drawRectFilled(uint32_t x, uint32_t y, uint32_t w, uint32_t h, Color col);
+
+    void drawRect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t borderSize, Color col);
+
+    void print(uint32_t x, uint32_t y, std::string_view text, uint32_t fontSize, Color col, TextAlign align = TEXT_ALIGN_LEFT);
+
+    /**
+     * Adds a decoded image. Images are compared by their address, so it must stay alive and unchanged while the
+     * screen is shown.
+     */
+    void drawImage(uint32_t x, uint32_t y, const DecodedImage &image);
+
+    void endFrame();
+
+    /**
+     * Forces a full repaint in the next frames.
+     */
+    void invalidate();
+
+private:
+    enum ItemType {
+        ITEM_RECT_FILLED,
+        ITEM_TEXT,
+        ITEM_IMAGE,
+    };
+
+    struct Item {
+        ItemType type              = ITEM_RECT_FILLED;
+        Rect bounds                = {};
+        uint32_t x                 = 0;
+        uint32_t y                 = 0;
+        uint32_t w                 = 0;
+        uint32_t h                 = 0;
+        Color color                = Color(0);
+        TextAlign align            = TEXT_ALIGN_LEFT;
+        const DecodedImage *image  = nullptr;
+        // kept when the item is reused, so unchanged text isn't laid out again
+        TextRun run;
+        // of everything that changes what the item draws
+        uint64_t hash = 0;
+
+        void updateHash();
+    };
+
+    // what is left of an item once it got drawn into a buffer
+    struct DrawnItem {
+        Rect bounds;
+        uint64_t hash;
+    };
+
+    Item &addItem(ItemType type);
+
+    template<typename T>
+    static bool containsHash(const std::vector<T> &items, uint32_t count, uint64_t hash);
+
+    void drawItem(const Item &item) const;
+
+    void drawBackground() const;
+
+    std::function<void()> mStaticDrawFn;
+    ScreenLayer mStaticLayer;
+    Color mStaticLayerBackground = Color(0);
+    bool mStaticLayerFailed      = false;
+
+    std::vector<Item> mItems;
+    uint32_t mItemCount = 0;
+    Color mBackground  = Color(0);
+
+    // what got drawn into the two screen buffers and the canvas, see DrawUtils::getTargetIndex
+    std::vector<DrawnItem> mDrawn[3];
+    uint32_t mDrawnCount[3]   = {};
+    Color mDrawnBackground[3] = {Color(0), Color(0), Color(0)};
+    bool mDrawnValid[3]       = {};
+};
@@ -1,13 +1,28 @@
 #include "DrawUtils.h"
 
+#include "LatencyMonitor.h"
 #include "MenuUtils.h"
 #include "logger.h"
 #include "utils.h"
+#include "utils/Blend.h"
+#include "utils/GlyphCache.h"
+#include "utils/GlyphCacheFile.h"
+#include "utils/SdfGlyph.h"
+#include "utils/UpscaleMap.h"
+#include "utils/Utf8Decoder.h"
 #include <coreinit/cache.h>
+#include <coreinit/core.h>
 #include <coreinit/memory.h>
 #include <coreinit/savedframe.h>
 #include <coreinit/screen.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <gx2/display.h>
 #include <gx2/state.h>
 #include <malloc.h>
@@ -24,9 +39,162 @@ uint32_t DrawUtils::tvSize    = 0;
 uint8_t *DrawUtils::drcBuffer = nullptr;
 uint32_t DrawUtils::drcSize   = 0;
 static SFT pFont              = {};
+static uint32_t fontSize      = 20;
+
+// size of the currently used tv mode
+static uint32_t tvWidth  = TV_WIDTH;
+static uint32_t tvHeight = 720;
+
+// maps logical columns/rows to the first tv column/row they cover, pixel i covers [map[i], map[i + 1])
+static uint16_t tvColumnMap[SCREEN_WIDTH + 1];
+static uint16_t tvRowMap[SCREEN_HEIGHT + 1];
+
+// back buffers of the current frame
+static uint32_t *drcBackBuffer = nullptr;
+static uint32_t *tvBackBuffer  = nullptr;
+
+// logical 854x480 canvas, gets copied to the drc and upscaled to the tv in endDraw
+static uint32_t *canvas               = nullptr;
+static bool canvasEnabled             = true;
+static OSTime frameStartTime          = 0;
+static uint32_t frameStartAllocations = 0;
+
+// statistics of all frames, framesHash only gets updated by the memory backend
+static uint32_t frameCount = 0;
+static OSTime drawTime     = 0;
+static uint32_t framesHash = 0;
+
+// screen buffers in plain memory instead of OSScreen, double buffered like OSScreen does it
+#define MEMORY_TV_BUFFER_SIZE  (TV_WIDTH * 720 * 4 * 2)
+#define MEMORY_DRC_BUFFER_SIZE (DRC_WIDTH * 480 * 4 * 2)
+static bool memoryBackend = false;
+
+// where primitives are drawing into. tvTarget is nullptr when drawing into the canvas
+static uint32_t *logicalTarget = nullptr;
+static uint32_t logicalPitch   = DRC_WIDTH;
+static uint32_t *tvTarget      = nullptr;
+
+// Canvas regions each of the two screen buffers is missing, because they changed after the buffer was last presented.
+// full means the whole canvas, e.g. when there were too many regions or the buffer content is unknown.
+#define MAX_PENDING_RECTS 32
+struct PendingRects {
+    Rect rects[MAX_PENDING_RECTS];
+    uint32_t count;
+    bool full;
+};
+static PendingRects pendingRects[2] = {{{}, 0, true}, {{}, 0, true}};
+
+// drawing outside this rectangle is discarded
+static Rect clipRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+// who drew the current content of the two screen buffers and the canvas, see claimTarget
+static const void *targetOwners[3] = {};
+static const void *previousOwner   = nullptr;
 
 static Color font_col(0xFFFFFFFF);
 
+// rendered glyphs of all font sizes, created in initFont
+#define GLYPH_CACHE_ARENA_SIZE  (256 * 1024)
+#define GLYPH_CACHE_MAX_ENTRIES 512
+static bool glyphCacheEnabled = true;
+static GlyphCache *glyphCache = nullptr;
+
+// glyphs rendered in earlier boots, so the first frame doesn't have to rasterize every glyph on screen
+static std::string glyphCachePath;
+static uint32_t glyphCacheKey         = 0;
+static uint32_t loadedGlyphInsertions = 0;
+static OSTime fontInitTime            = 0;
+
+// used when the glyph cache couldn't be allocated or the glyph doesn't fit into it
+static CachedGlyph uncachedGlyph = {};
+static std::unique_ptr<uint8_t[]> uncachedPixels;
+static uint32_t uncachedPixelsSize = 0;
+
+// distance fields at SDF_REFERENCE_SIZE, see utils/SdfGlyph.h
+#define SDF_CACHE_ARENA_SIZE  (256 * 1024)
+#define SDF_CACHE_MAX_ENTRIES 256
+static bool sdfEnabled      = true;
+static GlyphCache *sdfCache = nullptr;
+
+// scratch memory for rendering glyphs, big enough for the size 100 pin symbols of the pair screen
+#define FONT_ARENA_SIZE (256 * 1024)
+static SFT_Arena fontArena = {};
+
+// glyphs of the prewarm set of initFont get rendered into their own memory on another core
+#define PREWARM_STACK_SIZE       (64 * 1024)
+#define PREWARM_PIXELS_SIZE      (128 * 1024)
+#define PREWARM_SDF_ARENA_SIZE   (64 * 1024)
+#define PREWARM_SDF_MAX_ENTRIES  64
+static void startPrewarmWorker(std::span<const GlyphPrewarm> prewarm);
+static void stopPrewarmWorker();
+static void reapPrewarmWorkers(bool wait);
+
+// Replicates a row of logical pixels into all tv pixels they cover.
+static void upscaleRow(uint32_t *tv, uint32_t x, uint32_t y, const uint32_t *src, uint32_t count) {
+    uint32_t *tvRow = tv + tvRowMap[y] * tvWidth;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t value = src[i];
+        for (uint32_t xx = tvColumnMap[x + i]; xx < tvColumnMap[x + i + 1]; xx++) {
+            tvRow[xx] = value;
+        }
+    }
+    uint32_t tvX = tvColumnMap[x];
+    uint32_t tvW = tvColumnMap[x + count] - tvX;
+    for (uint32_t yy = tvRowMap[y] + 1; yy < tvRowMap[y + 1]; yy++) {
+        memcpy(tv + yy * tvWidth + tvX, tvRow + tvX, tvW * sizeof(uint32_t));
+    }
+}
+
+static Rect clipToScreen(const Rect &rect) {
+    Rect res;
+    res.x0 = std::max<int32_t>(rect.x0, 0);
+    res.y0 = std::max<int32_t>(rect.y0, 0);
+    res.x1 = std::min<int32_t>(rect.x1, SCREEN_WIDTH);
+    res.y1 = std::min<int32_t>(rect.y1, SCREEN_HEIGHT);
+    return res;
+}
+
+static void invalidatePendingRects() {
+    for (auto &pending : pendingRects) {
+        pending.count = 0;
+        pending.full  = true;
+    }
+}
+
+static void addPendingRect(PendingRects &pending, const Rect &rect) {
+    if (pending.full) {
+        return;
+    }
+    if (pending.count == MAX_PENDING_RECTS) {
+        pending.full = true;
+        return;
+    }
+    pending.rects[pending.count++] = rect;
+}
+
+// Copies a part of the canvas to the drc back buffer and upscales it to the tv back buffer.
+static void presentCanvasRect(const Rect &rect, uint32_t *drc, uint32_t *tv) {
+    if (rect.empty()) {
+        return;
+    }
+    uint32_t width = rect.x1 - rect.x0;
+    for (int32_t y = rect.y0; y < rect.y1; y++) {
+        const uint32_t *src = canvas + y * SCREEN_WIDTH + rect.x0;
+        memcpy(drc + y * DRC_WIDTH + rect.x0, src, width * sizeof(uint32_t));
+
+        upscaleRow(tv, rect.x0, y, src, width);
+    }
+}
+
+ScreenLayer::~ScreenLayer() {
+    release();
+}
+
+void ScreenLayer::release() {
+    free(mPixels);
+    mPixels = nullptr;
+}
+
 void DrawUtils::ClearSavedFrameBuffers() {
     // If GX2 is running make sure to shut it down and free all existing memory in the saved-frame area.
     if (GX2GetMainCoreId() != -1) {
@@ -42,6 +210,14 @@ void DrawUtils::ClearSavedFrameBuffers() {
 }
 
 void *DrawUtils::InitOSScreen() {
+    if (memoryBackend) {
+        auto *screenBuffer = (uint8_t *) memalign(0x100, MEMORY_TV_BUFFER_SIZE + MEMORY_DRC_BUFFER_SIZE);
+        if (screenBuffer != nullptr) {
+            memset(screenBuffer, 0, MEMORY_TV_BUFFER_SIZE + MEMORY_DRC_BUFFER_SIZE);
+        }
+        return screenBuffer;
+    }
+
     ClearSavedFrameBuffers();
 
     OSScreenInit();
@@ -62,104 +238,410 @@ void *DrawUtils::InitOSScreen() {
     return screenBuffer;
 }
 
+void DrawUtils::setMemoryBackend(bool enabled) {
+    memoryBackend = enabled;
+}
+
+bool DrawUtils::isMemoryBackend() {
+    return memoryBackend;
+}
+
+uint32_t DrawUtils::getBufferSize(OSScreenID screen) {
+    if (memoryBackend) {
+        return screen == SCREEN_TV ? MEMORY_TV_BUFFER_SIZE : MEMORY_DRC_BUFFER_SIZE;
+    }
+    return OSScreenGetBufferSizeEx(screen);
+}
+
+uint32_t DrawUtils::getFrameCount() {
+    return frameCount;
+}
+
+uint64_t DrawUtils::getDrawTimeUs() {
+    return OSTicksToMicroseconds(drawTime);
+}
+
+// FNV-1a over whole pixels instead of bytes, cheap enough to hash every frame of the memory backend
+static uint32_t hashPixels(const uint32_t *pixels, uint32_t count, uint32_t hash) {
+    for (uint32_t i = 0; i < count; i++) {
+        hash = (hash ^ pixels[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+uint32_t DrawUtils::getFramesHash() {
+    return framesHash;
+}
+
 void DrawUtils::initBuffers(void *tvBuffer, uint32_t tvSize, void *drcBuffer, uint32_t drcSize) {
     DrawUtils::tvBuffer  = (uint8_t *) tvBuffer;
     DrawUtils::tvSize    = tvSize;
     DrawUtils::drcBuffer = (uint8_t *) drcBuffer;
     DrawUtils::drcSize   = drcSize;
+
+    // the statistics are per session, UiSession reports them before deinitBuffers
+    frameCount = 0;
+    drawTime   = 0;
+    framesHash = 0;
+
+    if (tvSize == 0x00FD2000) {
+        tvWidth = 1920;
+    } else {
+        tvWidth = TV_WIDTH;
+    }
+    tvHeight = tvSize / 2 / 4 / tvWidth;
+
+    BuildUpscaleMap(tvColumnMap, SCREEN_WIDTH, tvWidth);
+    BuildUpscaleMap(tvRowMap, SCREEN_HEIGHT, tvHeight);
+
+    if (canvasEnabled && !canvas) {
+        canvas = (uint32_t *) memalign(0x40, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint32_t));
+        if (!canvas) {
+            DEBUG_FUNCTION_LINE_WARN("Failed to allocate canvas, drawing directly into the screen buffers");
+        }
+    }
+
+    drcBackBuffer = (uint32_t *) drcBuffer;
+    tvBackBuffer  = (uint32_t *) tvBuffer;
+    updateTargets();
+
+    memset(targetOwners, 0, sizeof(targetOwners));
+    invalidatePendingRects();
 }
 
-void DrawUtils::beginDraw() {
-    uint32_t pixel = *(uint32_t *) tvBuffer;
+void DrawUtils::deinitBuffers() {
+    free(canvas);
+    canvas = nullptr;
+
+    tvBuffer      = nullptr;
+    drcBuffer     = nullptr;
+    drcBackBuffer = nullptr;
+    tvBackBuffer  = nullptr;
+    updateTargets();
+}
+
+void DrawUtils::setCanvasEnabled(bool enabled) {
+    canvasEnabled = enabled;
+    if (!enabled) {
+        free(canvas);
+        canvas = nullptr;
+    } else if (!canvas && drcBuffer) {
+        canvas = (uint32_t *) memalign(0x40, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint32_t));
+        if (!canvas) {
+            DEBUG_FUNCTION_LINE_WARN("Failed to allocate canvas, drawing directly into the screen buffers");
+        } else {
+            // the canvas is not cleared on every frame, so start with the content of the drc
+            for (uint32_t y = 0; y < SCREEN_HEIGHT; y++) {
+                memcpy(canvas + y * SCREEN_WIDTH, drcBackBuffer + y * DRC_WIDTH, SCREEN_WIDTH * sizeof(uint32_t));
+            }
+            invalidatePendingRects();
+        }
+    }
+    updateTargets();
+
+    memset(targetOwners, 0, sizeof(targetOwners));
+}
+
+bool DrawUtils::isCanvasEnabled() {
+    return canvas != nullptr;
+}
+
+/**
+ * Parses "<setting>=0" or "<setting>=1".
+ */
+static bool parseRenderSetting(std::string_view line) {
+    auto equal = line.find('=');
+    if (equal == std::string_view::npos) {
+        return false;
+    }
+    auto name  = TrimWhitespace(line.substr(0, equal));
+    auto value = TrimWhitespace(line.substr(equal + 1));
+    if (value != "0" && value != "1") {
+        return false;
+    }
+    bool enabled = value == "1";
+
+    if (name == "canvas") {
+        DrawUtils::setCanvasEnabled(enabled);
+        return true;
+    } else if (name == "sdf_text") {
+        DrawUtils::setSdfTextEnabled(enabled);
+        return true;
+    }
+    return false;
+}
+
+void DrawUtils::loadRenderSettings(const std::string &path) {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) {
+        return;
+    }
+
+    char buf[128]{};
+    while (fgets(buf, sizeof(buf), f)) {
+        auto line = TrimWhitespace(buf);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (!parseRenderSetting(line)) {
+            DEBUG_FUNCTION_LINE_WARN("Ignoring invalid render setting \"%.*s\"", (int) line.size(), line.data());
+            continue;
+        }
+        DEBUG_FUNCTION_LINE_INFO("Render setting \"%.*s\"", (int) line.size(), line.data());
+    }
+    fclose(f);
+}
 
-    // check which buffer is currently used
-    OSScreenPutPixelEx(SCREEN_TV, 0, 0, 0xABCDEF90);
-    if (*(uint32_t *) tvBuffer == 0xABCDEF90) {
-        isBackBuffer = false;
+void DrawUtils::updateTargets() {
+    if (canvas) {
+        logicalTarget = canvas;
+        logicalPitch  = SCREEN_WIDTH;
+        tvTarget      = nullptr;
     } else {
-        isBackBuffer = true;
+        logicalTarget = drcBackBuffer;
+        logicalPitch  = DRC_WIDTH;
+        tvTarget      = tvBackBuffer;
     }
+}
+
+void DrawUtils::beginDraw() {
+    // the memory backend keeps track of its back buffer in endDraw
+    if (!memoryBackend) {
+        uint32_t pixel = *(uint32_t *) tvBuffer;
+
+        // check which buffer is currently used
+        OSScreenPutPixelEx(SCREEN_TV, 0, 0, 0xABCDEF90);
+        if (*(uint32_t *) tvBuffer == 0xABCDEF90) {
+            isBackBuffer = false;
+        } else {
+            isBackBuffer = true;
+        }
+
+        // restore the pixel we used for checking
+        *(uint32_t *) tvBuffer = pixel;
+    }
+
+    drcBackBuffer = (uint32_t *) drcBuffer;
+    tvBackBuffer  = (uint32_t *) tvBuffer;
+    if (isBackBuffer) {
+        drcBackBuffer += drcSize / 2 / 4;
+        tvBackBuffer += tvSize / 2 / 4;
+    }
+    updateTargets();
 
-    // restore the pixel we used for checking
-    *(uint32_t *) tvBuffer = pixel;
+    // nobody owns the content of the target until claimTarget gets called
+    uint32_t target      = getTargetIndex();
+    previousOwner        = targetOwners[target];
+    targetOwners[target] = nullptr;
+
+    frameStartTime        = OSGetTime();
+    frameStartAllocations = GetAllocationCount();
 }
 
 void DrawUtils::endDraw() {
+    Rect screen(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    endDraw(std::span(&screen, 1));
+}
+
+void DrawUtils::endDraw(std::span<const Rect> dirty) {
+    if (canvas) {
+        // The back buffer still shows the frame before the last one, so it gets the regions that changed in the last
+        // frame as well. The other buffer gets the regions of this frame the next time.
+        PendingRects &pending = pendingRects[isBackBuffer ? 1 : 0];
+        PendingRects &next    = pendingRects[isBackBuffer ? 0 : 1];
+        Rect screen(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+        bool full = pending.full;
+        for (const auto &rect : dirty) {
+            full = full || clipToScreen(rect) == screen;
+        }
+        if (full) {
+            presentCanvasRect(screen, drcBackBuffer, tvBackBuffer);
+        } else {
+            for (uint32_t i = 0; i < pending.count; i++) {
+                presentCanvasRect(pending.rects[i], drcBackBuffer, tvBackBuffer);
+            }
+            for (const auto &rect : dirty) {
+                presentCanvasRect(clipToScreen(rect), drcBackBuffer, tvBackBuffer);
+            }
+        }
+        pending.count = 0;
+        pending.full  = false;
+        for (const auto &rect : dirty) {
+            addPendingRect(next, clipToScreen(rect));
+        }
+    }
+
     // OSScreenFlipBuffersEx already flushes the cache?
     // DCFlushRange(tvBuffer, tvSize);
     // DCFlushRange(drcBuffer, drcSize);
 
-    OSScreenFlipBuffersEx(SCREEN_DRC);
-    OSScreenFlipBuffersEx(SCREEN_TV);
+    if (memoryBackend) {
+        isBackBuffer = !isBackBuffer;
+    } else {
+        OSScreenFlipBuffersEx(SCREEN_DRC);
+        OSScreenFlipBuffersEx(SCREEN_TV);
+    }
+    LatencyMonitor::frameFlipped(OSGetSystemTime());
+
+    frameCount++;
+    drawTime += OSGetTime() - frameStartTime;
+    if (memoryBackend) {
+        // drcBackBuffer is still the buffer of this frame, only beginDraw switches it
+        for (uint32_t y = 0; y < SCREEN_HEIGHT; y++) {
+            framesHash = hashPixels(drcBackBuffer + y * DRC_WIDTH, SCREEN_WIDTH, framesHash);
+        }
+    }
+
+    DEBUG_FUNCTION_LINE_VERBOSE("Frame took %lld us (%s), %d allocations", OSTicksToMicroseconds(OSGetTime() - frameStartTime), canvas ? "canvas" : "direct",
+                                GetAllocationCount() - frameStartAllocations);
+    if (fontInitTime != 0) {
+        DEBUG_FUNCTION_LINE_INFO("First frame took %lld us since initFont", OSTicksToMicroseconds(OSGetTime() - fontInitTime));
+        fontInitTime = 0;
+    }
 }
 
 void DrawUtils::clear(Color col) {
+    col.a = 0xFF;
+    if (clipRect != Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        drawRectFilled(clipRect.x0, clipRect.y0, clipRect.x1 - clipRect.x0, clipRect.y1 - clipRect.y0, col);
+        return;
+    }
+    if (canvas) {
+        FillSpan(canvas, SCREEN_WIDTH * SCREEN_HEIGHT, col);
+        return;
+    }
+    if (memoryBackend) {
+        FillSpan(tvBackBuffer, tvSize / 2 / 4, col);
+        FillSpan(drcBackBuffer, drcSize / 2 / 4, col);
+        return;
+    }
     OSScreenClearBufferEx(SCREEN_TV, col.color);
     OSScreenClearBufferEx(SCREEN_DRC, col.color);
 }
 
-void DrawUtils::drawPixel(uint32_t x, uint32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-    float opacity = a / 255.0f;
+bool DrawUtils::captureLayer(ScreenLayer &layer) {
+    if (!logicalTarget) {
+        return false;
+    }
+    if (!layer.mPixels) {
+        layer.mPixels = (uint32_t *) memalign(0x40, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint32_t));
+        if (!layer.mPixels) {
+            DEBUG_FUNCTION_LINE_WARN("Failed to allocate screen layer");
+            return false;
+        }
+    }
+    for (uint32_t y = 0; y < SCREEN_HEIGHT; y++) {
+        memcpy(layer.mPixels + y * SCREEN_WIDTH, logicalTarget + y * logicalPitch, SCREEN_WIDTH * sizeof(uint32_t));
+    }
+    return true;
+}
 
-    // put pixel in the drc buffer
-    uint32_t i = (x + y * DRC_WIDTH) * 4;
-    if (i + 3 < drcSize / 2) {
-        if (isBackBuffer) {
-            i += drcSize / 2;
-        }
-        if (a == 0xFF) {
-            drcBuffer[i]     = r;
-            drcBuffer[i + 1] = g;
-            drcBuffer[i + 2] = b;
-        } else {
-            drcBuffer[i]     = r * opacity + drcBuffer[i] * (1 - opacity);
-            drcBuffer[i + 1] = g * opacity + drcBuffer[i + 1] * (1 - opacity);
-            drcBuffer[i + 2] = b * opacity + drcBuffer[i + 2] * (1 - opacity);
+void DrawUtils::drawLayer(const ScreenLayer &layer) {
+    if (!layer.mPixels || clipRect.empty()) {
+        return;
+    }
+    uint32_t x     = clipRect.x0;
+    uint32_t count = clipRect.x1 - clipRect.x0;
+    for (uint32_t y = clipRect.y0; y < (uint32_t) clipRect.y1; y++) {
+        const uint32_t *src = layer.mPixels + y * SCREEN_WIDTH + x;
+        memcpy(logicalTarget + y * logicalPitch + x, src, count * sizeof(uint32_t));
+        if (tvTarget) {
+            upscaleRow(tvTarget, x, y, src, count);
         }
     }
+}
+
+void DrawUtils::setClipRect(const Rect &rect) {
+    clipRect.x0 = rect.x0 < 0 ? 0 : rect.x0;
+    clipRect.y0 = rect.y0 < 0 ? 0 : rect.y0;
+    clipRect.x1 = rect.x1 > SCREEN_WIDTH ? SCREEN_WIDTH : rect.x1;
+    clipRect.y1 = rect.y1 > SCREEN_HEIGHT ? SCREEN_HEIGHT : rect.y1;
+}
+
+void DrawUtils::resetClipRect() {
+    clipRect = Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+bool DrawUtils::claimTarget(const void *owner) {
+    targetOwners[getTargetIndex()] = owner;
+    return owner != nullptr && previousOwner == owner;
+}
+
+uint32_t DrawUtils::getTargetIndex() {
+    if (canvas) {
+        return 2;
+    }
+    return isBackBuffer ? 1 : 0;
+}
+
+void DrawUtils::drawPixel(uint32_t x, uint32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    if ((int32_t) x < clipRect.x0 || (int32_t) x >= clipRect.x1 || (int32_t) y < clipRect.y0 || (int32_t) y >= clipRect.y1) {
+        return;
+    }
+    Color col(r, g, b, a);
 
-    uint32_t USED_TV_WIDTH = TV_WIDTH;
-    float scale            = 1.5f;
-    if (DrawUtils::tvSize == 0x00FD2000) {
-        USED_TV_WIDTH = 1920;
-        scale         = 2.25f;
+    // put pixel in the drc buffer
+    FillSpan(logicalTarget + x + y * logicalPitch, 1, col);
+    if (!tvTarget) {
+        return;
     }
 
     // scale and put pixel in the tv buffer
-    for (uint32_t yy = (y * scale); yy < ((y * scale) + (uint32_t) scale); yy++) {
-        for (uint32_t xx = (x * scale); xx < ((x * scale) + (uint32_t) scale); xx++) {
-            uint32_t i = (xx + yy * USED_TV_WIDTH) * 4;
-            if (i + 3 < tvSize / 2) {
-                if (isBackBuffer) {
-                    i += tvSize / 2;
-                }
-                if (a == 0xFF) {
-                    tvBuffer[i]     = r;
-                    tvBuffer[i + 1] = g;
-                    tvBuffer[i + 2] = b;
-                } else {
-                    tvBuffer[i]     = r * opacity + tvBuffer[i] * (1 - opacity);
-                    tvBuffer[i + 1] = g * opacity + tvBuffer[i + 1] * (1 - opacity);
-                    tvBuffer[i + 2] = b * opacity + tvBuffer[i + 2] * (1 - opacity);
-                }
-            }
-        }
+    uint32_t tvX = tvColumnMap[x];
+    uint32_t tvW = tvColumnMap[x + 1] - tvX;
+    for (uint32_t yy = tvRowMap[y]; yy < tvRowMap[y + 1]; yy++) {
+        FillSpan(tvTarget + tvX + yy * tvWidth, tvW, col);
     }
 }
 
 void DrawUtils::drawRectFilled(uint32_t x, uint32_t y, uint32_t w, uint32_t h, Color col) {
-    for (uint32_t yy = y; yy < y + h; yy++) {
-        for (uint32_t xx = x; xx < x + w; xx++) {
-            drawPixel(xx, yy, col);
-        }
+    if (x >= (uint32_t) clipRect.x1 || y >= (uint32_t) clipRect.y1 || w == 0 || h == 0) {
+        return;
+    }
+    // clip once, then fill row spans
+    uint32_t x1 = (w > clipRect.x1 - x) ? clipRect.x1 : x + w;
+    uint32_t y1 = (h > clipRect.y1 - y) ? clipRect.y1 : y + h;
+    if (x < (uint32_t) clipRect.x0) {
+        x = clipRect.x0;
+    }
+    if (y < (uint32_t) clipRect.y0) {
+        y = clipRect.y0;
+    }
+    if (x >= x1 || y >= y1) {
+        return;
+    }
+
+    // drc buffer has the same resolution as our logical screen
+    for (uint32_t yy = y; yy < y1; yy++) {
+        FillSpan(logicalTarget + yy * logicalPitch + x, x1 - x, col);
+    }
+    if (!tvTarget) {
+        return;
+    }
+
+    // the tv rectangle is looked up from the upscale maps
+    uint32_t tvX = tvColumnMap[x];
+    uint32_t tvW = tvColumnMap[x1] - tvX;
+    for (uint32_t yy = tvRowMap[y]; yy < tvRowMap[y1]; yy++) {
+        FillSpan(tvTarget + yy * tvWidth + tvX, tvW, col);
     }
 }
 
 void DrawUtils::drawRect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t borderSize, Color col) {
+    if (borderSize * 2 >= w || borderSize * 2 >= h) {
+        drawRectFilled(x, y, w, h, col);
+        return;
+    }
     drawRectFilled(x, y, w, borderSize, col);
     drawRectFilled(x, y + h - borderSize, w, borderSize, col);
-    drawRectFilled(x, y, borderSize, h, col);
-    drawRectFilled(x + w - borderSize, y, borderSize, h, col);
+    // the side borders don't overlap the top and bottom ones, so translucent corners are only blended once
+    drawRectFilled(x, y + borderSize, borderSize, h - borderSize * 2, col);
+    drawRectFilled(x + w - borderSize, y + borderSize, borderSize, h - borderSize * 2, col);
+}
+
+static inline uint32_t readLE32(const uint8_t *data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t) data[3] << 24);
 }
 
 void DrawUtils::drawBitmap(uint32_t x, uint32_t y, uint32_t target_width, uint32_t target_height, const uint8_t *data) {
@@ -168,80 +650,252 @@ void DrawUtils::drawBitmap(uint32_t x, uint32_t y, uint32_t target_width, uint32
         return;
     }
 
-    uint32_t dataPos = __builtin_bswap32(*(uint32_t *) &(data[0x0A]));
-    uint32_t width   = __builtin_bswap32(*(uint32_t *) &(data[0x12]));
-    uint32_t height  = __builtin_bswap32(*(uint32_t *) &(data[0x16]));
+    uint32_t dataPos = readLE32(data + 0x0A);
+    auto width       = (int32_t) readLE32(data + 0x12);
+    auto height      = (int32_t) readLE32(data + 0x16);
+    uint32_t bpp     = data[0x1C] | (data[0x1D] << 8);
 
     if (dataPos == 0) {
         dataPos = 54;
     }
-
+    if (bpp != 24 || width <= 0 || height == 0 || target_width == 0 || target_height == 0) {
+        return;
+    }
+    // rows are stored bottom-up unless the height is negative, and padded to 4 bytes
+    bool bottomUp     = height > 0;
+    uint32_t rowCount = bottomUp ? height : -height;
+    uint32_t stride   = (width * 3 + 3) & ~3;
     data += dataPos;
 
-    // TODO flip image since bitmaps are stored upside down
+    if (x >= (uint32_t) clipRect.x1 || y >= (uint32_t) clipRect.y1) {
+        return;
+    }
+    uint32_t x0 = x < (uint32_t) clipRect.x0 ? clipRect.x0 : x;
+    uint32_t y0 = y < (uint32_t) clipRect.y0 ? clipRect.y0 : y;
+    uint32_t x1 = target_width > clipRect.x1 - x ? clipRect.x1 : x + target_width;
+    uint32_t y1 = target_height > clipRect.y1 - y ? clipRect.y1 : y + target_height;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    // source byte offset of every target column and source row of every target row, computed once
+    uint32_t columnOffsets[SCREEN_WIDTH];
+    const uint8_t *sourceRows[SCREEN_HEIGHT];
+    for (uint32_t xx = x0; xx < x1; xx++) {
+        columnOffsets[xx - x0] = (uint32_t) ((uint64_t) (xx - x) * width / target_width) * 3;
+    }
+    for (uint32_t yy = y0; yy < y1; yy++) {
+        auto row            = (uint32_t) ((uint64_t) (yy - y) * rowCount / target_height);
+        sourceRows[yy - y0] = data + (bottomUp ? rowCount - 1 - row : row) * stride;
+    }
 
-    for (uint32_t yy = y; yy < y + target_height; yy++) {
-        for (uint32_t xx = x; xx < x + target_width; xx++) {
-            uint32_t i = (((xx - x) * width / target_width) + ((yy - y) * height / target_height) * width) * 3;
-            drawPixel(xx, yy, data[i + 2], data[i + 1], data[i], 0xFF);
+    uint32_t count = x1 - x0;
+    for (uint32_t yy = y0; yy < y1; yy++) {
+        uint32_t *dst      = logicalTarget + yy * logicalPitch + x0;
+        const uint8_t *src = sourceRows[yy - y0];
+        if (yy > y0 && src == sourceRows[yy - y0 - 1]) {
+            // upscaled vertically, same as the row above
+            memcpy(dst, dst - logicalPitch, count * sizeof(uint32_t));
+        } else {
+            for (uint32_t i = 0; i < count; i++) {
+                const uint8_t *bgr = src + columnOffsets[i];
+                dst[i]             = Color(bgr[2], bgr[1], bgr[0], 0xFF).color;
+            }
+        }
+        if (tvTarget) {
+            upscaleRow(tvTarget, x0, yy, dst, count);
         }
     }
 }
 
-static void png_read_data(png_structp png_ptr, png_bytep outBytes, png_size_t byteCountToRead) {
-    void **data = (void **) png_get_io_ptr(png_ptr);
+DecodedImage::~DecodedImage() {
+    release();
+}
 
-    memcpy(outBytes, *data, byteCountToRead);
-    *((uint8_t **) data) += byteCountToRead;
+void DecodedImage::release() {
+    free(mPixels);
+    free(mRowTypes);
+    mPixels   = nullptr;
+    mRowTypes = nullptr;
+    mWidth    = 0;
+    mHeight   = 0;
+    mStride   = 0;
 }
 
-void DrawUtils::drawPNG(uint32_t x, uint32_t y, const uint8_t *data) {
+struct PNGReadState {
+    const uint8_t *data;
+    uint32_t remaining;
+};
+
+static void png_read_data(png_structp png_ptr, png_bytep outBytes, png_size_t byteCountToRead) {
+    auto *state = (PNGReadState *) png_get_io_ptr(png_ptr);
+    if (byteCountToRead > state->remaining) {
+        png_error(png_ptr, "Read past the end of the data");
+    }
+    memcpy(outBytes, state->data, byteCountToRead);
+    state->data += byteCountToRead;
+    state->remaining -= byteCountToRead;
+}
+
+bool DecodedImage::decodePNG(const uint8_t *data, uint32_t size) {
+    release();
+
     png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     if (png_ptr == nullptr) {
-        return;
+        return false;
     }
-
     png_infop info_ptr = png_create_info_struct(png_ptr);
     if (info_ptr == nullptr) {
         png_destroy_read_struct(&png_ptr, nullptr, nullptr);
-        return;
+        return false;
+    }
+    // libpng jumps back here on any error
+    png_bytep *volatile rows = nullptr;
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to decode PNG");
+        free((void *) rows);
+        png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+        release();
+        return false;
     }
 
-    png_set_read_fn(png_ptr, (void *) &data, png_read_data);
-
+    PNGReadState state = {data, size};
+    png_set_read_fn(png_ptr, &state, png_read_data);
     png_read_info(png_ptr, info_ptr);
 
-    uint32_t width  = 0;
-    uint32_t height = 0;
-    int bitDepth    = 0;
-    int colorType   = -1;
-    uint32_t retval = png_get_IHDR(png_ptr, info_ptr, &width, &height, &bitDepth, &colorType, nullptr, nullptr, nullptr);
-    if (retval != 1) {
-        return;
+    // let libpng convert everything to 8 bit RGBA
+    png_set_expand(png_ptr);
+    png_set_strip_16(png_ptr);
+    png_set_gray_to_rgb(png_ptr);
+    png_set_add_alpha(png_ptr, 0xFF, PNG_FILLER_AFTER);
+    png_set_interlace_handling(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+
+    uint32_t width  = png_get_image_width(png_ptr, info_ptr);
+    uint32_t height = png_get_image_height(png_ptr, info_ptr);
+    if (width == 0 || height == 0 || png_get_rowbytes(png_ptr, info_ptr) != width * 4) {
+        png_error(png_ptr, "Unsupported PNG");
+    }
+    rows = (png_bytep *) malloc(height * sizeof(png_bytep));
+    if (!rows || !allocate(width, height)) {
+        png_error(png_ptr, "Out of memory");
     }
+    for (uint32_t y = 0; y < height; y++) {
+        rows[y] = (png_bytep) (mPixels + y * mStride);
+    }
+    png_read_image(png_ptr, rows);
+    png_read_end(png_ptr, nullptr);
+    free((void *) rows);
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+
+    // RGBA bytes are already in the order of Color
+    premultiply();
+    return true;
+}
 
-    uint32_t bytesPerRow = png_get_rowbytes(png_ptr, info_ptr);
-    auto *rowData        = new uint8_t[bytesPerRow];
+bool DecodedImage::loadPixels(const uint32_t *pixels, uint32_t width, uint32_t height) {
+    release();
+    if (width == 0 || height == 0 || !allocate(width, height)) {
+        release();
+        return false;
+    }
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(mPixels + y * mStride, pixels + y * width, width * sizeof(uint32_t));
+    }
+    premultiply();
+    return true;
+}
 
-    for (uint32_t yy = y; yy < y + height; yy++) {
-        png_read_row(png_ptr, (png_bytep) rowData, nullptr);
+bool DecodedImage::allocate(uint32_t width, uint32_t height) {
+    mStride   = (width + 15) & ~15;
+    mPixels   = (uint32_t *) memalign(0x40, mStride * height * sizeof(uint32_t));
+    mRowTypes = (uint8_t *) malloc(height);
+    mWidth    = width;
+    mHeight   = height;
+    return mPixels && mRowTypes;
+}
 
-        for (uint32_t xx = x; xx < x + width; xx++) {
-            if (colorType == PNG_COLOR_TYPE_RGB_ALPHA) {
-                uint32_t i = (xx - x) * 4;
-                drawPixel(xx, yy, rowData[i], rowData[i + 1], rowData[i + 2], rowData[i + 3]);
-            } else if (colorType == PNG_COLOR_TYPE_RGB) {
-                uint32_t i = (xx - x) * 3;
-                drawPixel(xx, yy, rowData[i], rowData[i + 1], rowData[i + 2], 0xFF);
+void DecodedImage::premultiply() {
+    for (uint32_t y = 0; y < mHeight; y++) {
+        uint32_t *row  = mPixels + y * mStride;
+        bool allOpaque = true;
+        bool allEmpty  = true;
+        for (uint32_t x = 0; x < mWidth; x++) {
+            Color pixel(row[x]);
+            if (pixel.a != 0xFF) {
+                allOpaque = false;
+                pixel.r   = Div255(pixel.r * pixel.a);
+                pixel.g   = Div255(pixel.g * pixel.a);
+                pixel.b   = Div255(pixel.b * pixel.a);
+                row[x]    = pixel.color;
+            }
+            if (pixel.a != 0) {
+                allEmpty = false;
             }
         }
+        mRowTypes[y] = allOpaque ? ROW_OPAQUE : (allEmpty ? ROW_TRANSPARENT : ROW_BLENDED);
     }
+}
 
-    delete[] rowData;
-    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+void DrawUtils::drawPNG(uint32_t x, uint32_t y, const uint8_t *data, uint32_t size) {
+    DecodedImage image;
+    if (image.decodePNG(data, size)) {
+        drawImage(x, y, image);
+    }
+}
+
+void DrawUtils::drawImage(uint32_t x, uint32_t y, const DecodedImage &image) {
+    if (!image.mPixels || x >= (uint32_t) clipRect.x1 || y >= (uint32_t) clipRect.y1) {
+        return;
+    }
+    // clip once, then work on row spans
+    uint32_t x0 = x < (uint32_t) clipRect.x0 ? clipRect.x0 : x;
+    uint32_t y0 = y < (uint32_t) clipRect.y0 ? clipRect.y0 : y;
+    uint32_t x1 = image.mWidth > clipRect.x1 - x ? clipRect.x1 : x + image.mWidth;
+    uint32_t y1 = image.mHeight > clipRect.y1 - y ? clipRect.y1 : y + image.mHeight;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    uint32_t count = x1 - x0;
+    for (uint32_t yy = y0; yy < y1; yy++) {
+        uint8_t rowType = image.mRowTypes[yy - y];
+        if (rowType == DecodedImage::ROW_TRANSPARENT) {
+            continue;
+        }
+        const uint32_t *src = image.mPixels + (yy - y) * image.mStride + (x0 - x);
+        uint32_t *dst       = logicalTarget + yy * logicalPitch + x0;
+        if (rowType == DecodedImage::ROW_OPAQUE) {
+            memcpy(dst, src, count * sizeof(uint32_t));
+        } else {
+            for (uint32_t i = 0; i < count; i++) {
+                Color pixel(src[i]);
+                if (pixel.a == 0xFF) {
+                    dst[i] = pixel.color;
+                } else if (pixel.a != 0) {
+                    dst[i] = BlendPremultiplied(dst[i], pixel);
+                }
+            }
+        }
+        // the blended row is what the tv shows as well
+        if (tvTarget) {
+            upscaleRow(tvTarget, x0, yy, dst, count);
+        }
+    }
+}
+
+/**
+ * Identifies the font and everything else that changes the rendered glyphs, including the precision schrift was
+ * built with.
+ */
+static uint32_t getGlyphCacheKey(const void *font, uint32_t size) {
+    uint32_t renderConfig[] = {size, sdfEnabled, SDF_REFERENCE_SIZE, SDF_MAX_SIZE, SDF_PADDING, (uint32_t) sft_uses_float()};
+    uint32_t key            = HashGlyphData(renderConfig, sizeof(renderConfig));
+    return HashGlyphData(font, size, key);
 }
 
-bool DrawUtils::initFont() {
+bool DrawUtils::initFont(std::span<const GlyphPrewarm> prewarm) {
+    fontInitTime  = OSGetTime();
     void *font    = nullptr;
     uint32_t size = 0;
     OSGetSharedData(OS_SHAREDDATATYPE_FONT_STANDARD, 0, &font, &size);
@@ -250,157 +904,702 @@ bool DrawUtils::initFont() {
         pFont.xScale = 20;
         pFont.yScale = 20,
         pFont.flags  = SFT_DOWNWARD_Y;
-        pFont.font   = sft_loadmem(font, size);
+        pFont.font   = sft_loadmem_ex(font, size, SFT_DIRECT_CMAP);
+        fontSize     = 20;
         if (!pFont.font) {
             return false;
         }
+        fontArena        = {};
+        fontArena.memory = memalign(0x40, FONT_ARENA_SIZE);
+        if (fontArena.memory) {
+            fontArena.size = FONT_ARENA_SIZE;
+            pFont.arena    = &fontArena;
+        }
+        if (glyphCacheEnabled) {
+            glyphCache = new (std::nothrow) GlyphCache(GLYPH_CACHE_ARENA_SIZE, GLYPH_CACHE_MAX_ENTRIES);
+        }
+        if (glyphCache && !glyphCache->isValid()) {
+            delete glyphCache;
+            glyphCache = nullptr;
+        }
+        if (glyphCache && !glyphCachePath.empty()) {
+            // hashing the whole font takes a while, it's only done once per session
+            glyphCacheKey = getGlyphCacheKey(font, size);
+            if (LoadGlyphCacheFile(glyphCachePath, glyphCacheKey, *glyphCache)) {
+                DEBUG_FUNCTION_LINE_VERBOSE("Loaded %d glyphs from %s", glyphCache->getInsertions(), glyphCachePath.c_str());
+            }
+        }
+        loadedGlyphInsertions = glyphCache ? glyphCache->getInsertions() : 0;
+        sdfCache = new (std::nothrow) GlyphCache(SDF_CACHE_ARENA_SIZE, SDF_CACHE_MAX_ENTRIES);
+        if (sdfCache && !sdfCache->isValid()) {
+            delete sdfCache;
+            sdfCache = nullptr;
+        }
+        startPrewarmWorker(prewarm);
         OSMemoryBarrier();
         return true;
     }
     return false;
 }
 
+void DrawUtils::prewarmGlyphs(std::span<const GlyphPrewarm> prewarm) {
+    stopPrewarmWorker();
+    startPrewarmWorker(prewarm);
+}
+
 void DrawUtils::deinitFont() {
+    // the cancelled workers stop after at most one glyph, they must be done with the font before it goes away
+    stopPrewarmWorker();
+    reapPrewarmWorkers(true);
+    if (glyphCache) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Glyph cache: %d hits, %d misses, %d evictions, %d bytes used",
+                                    glyphCache->getHits(), glyphCache->getMisses(), glyphCache->getEvictions(), glyphCache->getUsedBytes());
+        // only write the file again if new glyphs got rendered
+        if (!glyphCachePath.empty() && glyphCache->getInsertions() > loadedGlyphInsertions) {
+            SaveGlyphCacheFile(glyphCachePath, glyphCacheKey, *glyphCache);
+        }
+        delete glyphCache;
+        glyphCache = nullptr;
+    }
+    if (sdfCache) {
+        DEBUG_FUNCTION_LINE_VERBOSE("SDF cache: %d hits, %d misses, %d evictions, %d bytes used",
+                                    sdfCache->getHits(), sdfCache->getMisses(), sdfCache->getEvictions(), sdfCache->getUsedBytes());
+        delete sdfCache;
+        sdfCache = nullptr;
+    }
+    uncachedPixels.reset();
+    uncachedPixelsSize = 0;
+    if (fontArena.memory) {
+        DEBUG_FUNCTION_LINE_VERBOSE("Font arena: %d of %d bytes used at peak, %d overflows", fontArena.peak, fontArena.size, fontArena.overflows);
+        free(fontArena.memory);
+        fontArena = {};
+    }
     sft_freefont(pFont.font);
     pFont.font = nullptr;
     pFont      = {};
 }
 
+void DrawUtils::setGlyphCacheFile(const std::string &path) {
+    glyphCachePath = path;
+}
+
+void DrawUtils::setGlyphCacheEnabled(bool enabled) {
+    glyphCacheEnabled = enabled;
+}
+
 void DrawUtils::setFontSize(uint32_t size) {
     pFont.xScale = size;
     pFont.yScale = size;
+    fontSize     = size;
     SFT_LMetrics metrics;
     sft_lmetrics(&pFont, &metrics);
 }
 
+void DrawUtils::setSdfTextEnabled(bool enabled) {
+    if (enabled == sdfEnabled) {
+        return;
+    }
+    sdfEnabled = enabled;
+    // cached and prewarmed glyphs were rendered the other way
+    stopPrewarmWorker();
+    if (glyphCache) {
+        glyphCache->clear();
+    }
+}
+
+bool DrawUtils::isSdfTextEnabled() {
+    return sdfEnabled;
+}
+
 void DrawUtils::setFontColor(Color col) {
     font_col = col;
 }
 
+// Same as BlendCoverageRun, but each coverage value is stretched over the tv columns of its logical pixel.
+static void blendCoverageRunUpscaled(uint32_t *tvRow, uint32_t x, const uint8_t *coverage, uint32_t count, const uint8_t *alphaTable, uint32_t opaque) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t alpha = alphaTable[coverage[i]];
+        if (alpha == 0) {
+            continue;
+        }
+        for (uint32_t xx = tvColumnMap[x + i]; xx < tvColumnMap[x + i + 1]; xx++) {
+            tvRow[xx] = alpha == 0xFF ? opaque : BlendColor(tvRow[xx], font_col, alpha);
+        }
+    }
+}
+
+// Draws a coverage bitmap in the font color. The glyph gets clipped once and is then walked row by row, the runs of
+// zero coverage between the strokes are skipped.
 static void draw_freetype_bitmap(SFT_Image *bmp, int32_t x, int32_t y) {
-    int32_t i, j, p, q;
+    int32_t x0 = x < clipRect.x0 ? clipRect.x0 : x;
+    int32_t y0 = y < clipRect.y0 ? clipRect.y0 : y;
+    int32_t x1 = x + bmp->width > clipRect.x1 ? clipRect.x1 : x + bmp->width;
+    int32_t y1 = y + bmp->height > clipRect.y1 ? clipRect.y1 : y + bmp->height;
+    if (x0 >= x1 || y0 >= y1 || font_col.a == 0) {
+        return;
+    }
 
-    int32_t x_max = x + bmp->width;
-    int32_t y_max = y + bmp->height;
+    // blended alpha for each coverage value, only changes with the alpha of the font color
+    static uint8_t alphaTable[256];
+    static uint32_t alphaTableAlpha = 0x100;
+    if (alphaTableAlpha != font_col.a) {
+        BuildCoverageAlphaTable(alphaTable, font_col.a);
+        alphaTableAlpha = font_col.a;
+    }
 
-    auto *src = (uint8_t *) bmp->pixels;
+    const uint32_t opaque = Color(font_col.r, font_col.g, font_col.b, 0xFF).color;
+    auto *src             = (const uint8_t *) bmp->pixels;
+    for (int32_t row = y0; row < y1; row++) {
+        const uint8_t *coverage = src + (row - y) * bmp->width + (x0 - x);
+        uint32_t count          = x1 - x0;
 
-    for (i = x, p = 0; i < x_max; i++, p++) {
-        for (j = y, q = 0; j < y_max; j++, q++) {
-            if (i < 0 || j < 0 || i >= SCREEN_WIDTH || j >= SCREEN_HEIGHT) {
-                continue;
+        uint32_t i = 0;
+        while (i < count) {
+            while (i < count && coverage[i] == 0) {
+                i++;
+            }
+            uint32_t runStart = i;
+            while (i < count && coverage[i] != 0) {
+                i++;
+            }
+            if (runStart == i) {
+                break;
             }
 
-            float opacity = src[q * bmp->width + p] / 255.0f;
-            DrawUtils::drawPixel(i, j, font_col.r, font_col.g, font_col.b, font_col.a * opacity);
+            uint32_t runX = x0 + runStart;
+            BlendCoverageRun(logicalTarget + row * logicalPitch + runX, coverage + runStart, i - runStart, alphaTable, font_col, opaque);
+            if (!tvTarget) {
+                continue;
+            }
+            // every logical pixel covers a uniform block of tv pixels, so the other tv rows are copies of the first one
+            uint32_t *tvRow = tvTarget + tvRowMap[row] * tvWidth;
+            blendCoverageRunUpscaled(tvRow, runX, coverage + runStart, i - runStart, alphaTable, opaque);
+            uint32_t tvX = tvColumnMap[runX];
+            uint32_t tvW = tvColumnMap[runX + i - runStart] - tvX;
+            for (uint32_t yy = tvRowMap[row] + 1; yy < tvRowMap[row + 1]; yy++) {
+                memcpy(tvTarget + yy * tvWidth + tvX, tvRow + tvX, tvW * sizeof(uint32_t));
+            }
         }
     }
 }
 
-void DrawUtils::print(uint32_t x, uint32_t y, const char *string, bool alignRight) {
-    auto *buffer = new wchar_t[strlen(string) + 1];
+/**
+ * Returns the distance field of a glyph at SDF_REFERENCE_SIZE, renders and caches it if needed.
+ * Changes the scale of sft.
+ */
+static const CachedGlyph *getSdfGlyph(SFT *sft, GlyphCache *cache, uint32_t codepoint, SFT_Glyph gid) {
+    const CachedGlyph *cached = cache->find(codepoint, SDF_REFERENCE_SIZE);
+    if (cached) {
+        return cached;
+    }
 
-    size_t num = mbstowcs(buffer, string, strlen(string));
-    if (num > 0) {
-        buffer[num] = 0;
-    } else {
-        wchar_t *tmp = buffer;
-        while ((*tmp++ = *string++))
-            ;
+    sft->xScale = SDF_REFERENCE_SIZE;
+    sft->yScale = SDF_REFERENCE_SIZE;
+    SFT_GMetrics mtx;
+    if (sft_gmetrics(sft, gid, &mtx) < 0 || mtx.minWidth == 0 || mtx.minHeight == 0) {
+        return nullptr;
+    }
+    int32_t width      = (mtx.minWidth + SDF_PADDING * 2 + 3) & ~3;
+    int32_t height     = mtx.minHeight + SDF_PADDING * 2;
+    CachedGlyph *glyph = cache->insert(codepoint, SDF_REFERENCE_SIZE, (uint32_t) (width * height));
+    if (!glyph) {
+        return nullptr;
+    }
+    glyph->advanceWidth    = mtx.advanceWidth;
+    glyph->leftSideBearing = mtx.leftSideBearing;
+    glyph->yOffset         = mtx.yOffset;
+    glyph->minHeight       = mtx.minHeight;
+    glyph->width           = width;
+    glyph->height          = height;
+
+    SFT_Image img = {
+            .pixels = glyph->pixels,
+            .width  = width,
+            .height = height,
+    };
+    if (sft_render_sdf(sft, gid, img, SDF_PADDING) < 0) {
+        cache->remove(codepoint, SDF_REFERENCE_SIZE);
+        return nullptr;
     }
+    return glyph;
+}
 
-    print(x, y, buffer, alignRight);
-    delete[] buffer;
+/**
+ * Fills the coverage of a glyph from its distance field instead of rasterizing the outline in this size.
+ */
+static bool renderFromSdf(SFT *sft, GlyphCache *sdfGlyphs, SFT_Glyph gid, CachedGlyph *glyph) {
+    const CachedGlyph *sdf = getSdfGlyph(sft, sdfGlyphs, glyph->codepoint, gid);
+    if (!sdf) {
+        return false;
+    }
+    ResampleSdf(sdf->pixels, sdf->width, sdf->height, (float) floor(sdf->leftSideBearing), (float) -sdf->yOffset,
+                glyph->pixels, glyph->width, glyph->height, (float) floor(glyph->leftSideBearing), (float) -glyph->yOffset,
+                (float) SDF_REFERENCE_SIZE / (float) glyph->fontSize);
+    return true;
 }
 
-void DrawUtils::print(uint32_t x, uint32_t y, const wchar_t *string, bool alignRight) {
-    auto penX = (int32_t) x;
-    auto penY = (int32_t) y;
+/**
+ * Looks up the glyph of a codepoint and its metrics in the given size. Changes the scale of sft.
+ */
+static bool loadGlyphMetrics(SFT *sft, uint32_t codepoint, uint32_t size, SFT_Glyph *gid, SFT_GMetrics *mtx) {
+    sft->xScale = size;
+    sft->yScale = size;
+    if (sft_lookup(sft, codepoint, gid) < 0) {
+        return false;
+    }
+    if (sft_gmetrics(sft, *gid, mtx) < 0) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to get glyph metrics");
+        return false;
+    }
+    return true;
+}
 
-    if (alignRight) {
-        penX -= getTextWidth(string);
+/**
+ * Renders a glyph whose metrics are already filled in. Sizes up to SDF_MAX_SIZE are resampled from the distance
+ * fields in sdfGlyphs, pass nullptr to always rasterize the outline. Changes the scale of sft.
+ */
+static bool rasterizeGlyph(SFT *sft, GlyphCache *sdfGlyphs, SFT_Glyph gid, CachedGlyph *glyph) {
+    if (glyph->width == 0 || glyph->height == 0) {
+        return true;
+    }
+    if (sdfGlyphs && glyph->fontSize <= SDF_MAX_SIZE && renderFromSdf(sft, sdfGlyphs, gid, glyph)) {
+        return true;
     }
+    sft->xScale   = glyph->fontSize;
+    sft->yScale   = glyph->fontSize;
+    SFT_Image img = {
+            .pixels = glyph->pixels,
+            .width  = glyph->width,
+            .height = glyph->height,
+    };
+    return sft_render(sft, gid, img) >= 0;
+}
 
-    uint16_t textureWidth = 0, textureHeight = 0;
-    for (; *string; string++) {
-        SFT_Glyph gid; //  unsigned long gid;
-        if (sft_lookup(&pFont, *string, &gid) >= 0) {
-            SFT_GMetrics mtx;
-            if (sft_gmetrics(&pFont, gid, &mtx) < 0) {
-                DEBUG_FUNCTION_LINE_ERR("Failed to get glyph metrics");
-                return;
-            }
+static void setGlyphMetrics(CachedGlyph *glyph, const SFT_GMetrics &mtx) {
+    glyph->advanceWidth    = mtx.advanceWidth;
+    glyph->leftSideBearing = mtx.leftSideBearing;
+    glyph->yOffset         = mtx.yOffset;
+    glyph->minHeight       = mtx.minHeight;
+    glyph->width           = (mtx.minWidth + 3) & ~3;
+    glyph->height          = mtx.minHeight;
+}
 
-            if (*string == '\n') {
-                penY += mtx.minHeight;
-                penX = x;
-                continue;
-            }
+/**
+ * Renders the prewarm set of initFont on another core. The worker has its own SFT, scratch arena and distance fields
+ * and only shares the read-only font with the UI thread. Each slot gets published through its ready flag, the
+ * UI thread never waits for the worker and renders glyphs that aren't ready yet itself.
+ *
+ * A cancelled worker stops at the next glyph, the UI thread doesn't wait for that. It gets joined and freed once its
+ * thread has ended, at the latest in deinitFont before the font goes away.
+ */
+struct PrewarmSlot {
+    CachedGlyph glyph;
+    std::atomic<bool> ready;
+};
+
+struct PrewarmWorker {
+    OSThread *thread;
+    uint8_t *stack;
+    SFT sft;
+    SFT_Arena scratch;
+    GlyphCache *sdfGlyphs; // nullptr if the glyphs are rasterized directly
+    PrewarmSlot *slots;
+    uint32_t slotCount;
+    uint8_t *pixels;
+    uint32_t pixelsSize;
+    std::atomic<bool> stop;
+};
+
+#define MAX_CANCELLED_PREWARM_WORKERS 8
+static PrewarmWorker *prewarmWorker = nullptr;
+// cancelled workers whose thread may still be running
+static PrewarmWorker *cancelledPrewarmWorkers[MAX_CANCELLED_PREWARM_WORKERS] = {};
+static uint32_t cancelledPrewarmWorkerCount                                  = 0;
+
+static void freePrewarmWorker(PrewarmWorker *worker) {
+    delete worker->sdfGlyphs;
+    free(worker->scratch.memory);
+    free(worker->pixels);
+    free(worker->stack);
+    free(worker->thread);
+    delete[] worker->slots;
+    delete worker;
+}
 
-            textureWidth  = (mtx.minWidth + 3) & ~3;
-            textureHeight = mtx.minHeight;
+static int prewarmThreadMain(int argc, const char **argv) {
+    auto *worker    = (PrewarmWorker *) argv;
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < worker->slotCount && !worker->stop.load(std::memory_order_relaxed); i++) {
+        CachedGlyph *glyph = &worker->slots[i].glyph;
+        SFT_Glyph gid;
+        SFT_GMetrics mtx;
+        if (!loadGlyphMetrics(&worker->sft, glyph->codepoint, glyph->fontSize, &gid, &mtx)) {
+            continue;
+        }
+        setGlyphMetrics(glyph, mtx);
+        uint32_t bitmapSize = (uint32_t) (glyph->width * glyph->height);
+        if (bitmapSize > worker->pixelsSize - offset) {
+            break;
+        }
+        glyph->pixels = worker->pixels + offset;
+        if (!rasterizeGlyph(&worker->sft, worker->sdfGlyphs, gid, glyph)) {
+            continue;
+        }
+        offset += (bitmapSize + 3) & ~3;
+        worker->slots[i].ready.store(true, std::memory_order_release);
+    }
+    return 0;
+}
 
-            SFT_Image img = {
-                    .pixels = nullptr,
-                    .width  = textureWidth,
-                    .height = textureHeight,
-            };
+/**
+ * Joins and frees the cancelled workers. Unless wait is set, only the ones whose thread has ended already.
+ */
+static void reapPrewarmWorkers(bool wait) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < cancelledPrewarmWorkerCount; i++) {
+        PrewarmWorker *worker = cancelledPrewarmWorkers[i];
+        if (!wait && !OSIsThreadTerminated(worker->thread)) {
+            cancelledPrewarmWorkers[kept++] = worker;
+            continue;
+        }
+        OSJoinThread(worker->thread, nullptr);
+        freePrewarmWorker(worker);
+    }
+    cancelledPrewarmWorkerCount = kept;
+}
+
+/**
+ * Cancels the current worker. Doesn't wait for it unless there are too many cancelled workers already.
+ */
+static void stopPrewarmWorker() {
+    if (!prewarmWorker) {
+        return;
+    }
+    prewarmWorker->stop.store(true, std::memory_order_relaxed);
+    reapPrewarmWorkers(false);
+    if (cancelledPrewarmWorkerCount == MAX_CANCELLED_PREWARM_WORKERS) {
+        reapPrewarmWorkers(true);
+    }
+    cancelledPrewarmWorkers[cancelledPrewarmWorkerCount++] = prewarmWorker;
+    prewarmWorker                                          = nullptr;
+}
 
-            if (textureWidth == 0) {
-                textureWidth = 4;
+static void startPrewarmWorker(std::span<const GlyphPrewarm> prewarm) {
+    // one slot per codepoint and size that isn't cached already
+    std::vector<CachedGlyph> glyphs;
+    for (const auto &entry : prewarm) {
+        Utf8Decoder decoder(entry.text);
+        uint32_t codepoint;
+        while (decoder.next(codepoint)) {
+            if (glyphCache && glyphCache->contains(codepoint, entry.fontSize)) {
+                continue;
             }
-            if (textureHeight == 0) {
-                textureHeight = 4;
+            if (std::any_of(glyphs.begin(), glyphs.end(), [&](const CachedGlyph &g) { return g.codepoint == codepoint && g.fontSize == entry.fontSize; })) {
+                continue;
             }
+            CachedGlyph glyph = {};
+            glyph.codepoint   = codepoint;
+            glyph.fontSize    = entry.fontSize;
+            glyphs.push_back(glyph);
+        }
+    }
+    if (glyphs.empty()) {
+        return;
+    }
 
-            auto buffer = make_unique_nothrow<uint8_t[]>((uint32_t) (img.width * img.height));
-            if (!buffer) {
-                DEBUG_FUNCTION_LINE_ERR("Failed to allocate memory for glyph");
-                return;
-            }
-            img.pixels = buffer.get();
-            if (sft_render(&pFont, gid, img) < 0) {
-                DEBUG_FUNCTION_LINE_ERR("Failed to render glyph");
-                return;
-            } else {
-                draw_freetype_bitmap(&img, (int32_t) (penX + mtx.leftSideBearing), (int32_t) (penY + mtx.yOffset));
-                penX += (int32_t) mtx.advanceWidth;
+    auto *worker = new (std::nothrow) PrewarmWorker();
+    if (!worker) {
+        return;
+    }
+    worker->slots      = new (std::nothrow) PrewarmSlot[glyphs.size()];
+    worker->slotCount  = glyphs.size();
+    worker->thread     = (OSThread *) memalign(0x10, sizeof(OSThread));
+    worker->stack      = (uint8_t *) memalign(0x10, PREWARM_STACK_SIZE);
+    worker->pixels     = (uint8_t *) memalign(0x40, PREWARM_PIXELS_SIZE);
+    worker->pixelsSize = PREWARM_PIXELS_SIZE;
+    if (sdfEnabled) {
+        worker->sdfGlyphs = new (std::nothrow) GlyphCache(PREWARM_SDF_ARENA_SIZE, PREWARM_SDF_MAX_ENTRIES);
+    }
+    worker->scratch.memory = memalign(0x40, FONT_ARENA_SIZE);
+    worker->scratch.size   = worker->scratch.memory ? FONT_ARENA_SIZE : 0;
+    if (!worker->slots || !worker->thread || !worker->stack || !worker->pixels || (sdfEnabled && (!worker->sdfGlyphs || !worker->sdfGlyphs->isValid()))) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to allocate the glyph prewarm worker");
+        freePrewarmWorker(worker);
+        return;
+    }
+    for (uint32_t i = 0; i < worker->slotCount; i++) {
+        worker->slots[i].glyph = glyphs[i];
+        worker->slots[i].ready.store(false, std::memory_order_relaxed);
+    }
+    worker->sft       = pFont;
+    worker->sft.arena = worker->scratch.memory ? &worker->scratch : nullptr;
+
+    // run on the next core, the UI thread keeps drawing the first frames meanwhile
+    auto affinity = (OSThreadAttributes) (OS_THREAD_ATTRIB_AFFINITY_CPU0 << ((OSGetCoreId() + 1) % 3));
+    if (!OSCreateThread(worker->thread, prewarmThreadMain, 0, (char *) worker, worker->stack + PREWARM_STACK_SIZE, PREWARM_STACK_SIZE, 16, affinity)) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to create the glyph prewarm thread");
+        freePrewarmWorker(worker);
+        return;
+    }
+    OSSetThreadName(worker->thread, "GlyphPrewarm");
+    prewarmWorker = worker;
+    OSResumeThread(worker->thread);
+    DEBUG_FUNCTION_LINE_VERBOSE("Prewarming %d glyphs", worker->slotCount);
+}
+
+/**
+ * Returns the glyph used when the glyph cache couldn't be allocated or a glyph doesn't fit into it, with room for a
+ * bitmap of bitmapSize bytes. It's only valid until the next call.
+ */
+static CachedGlyph *getUncachedGlyph(uint32_t codepoint, uint32_t size, uint32_t bitmapSize) {
+    if (uncachedPixelsSize < bitmapSize) {
+        uncachedPixels     = make_unique_nothrow<uint8_t[]>((size_t) bitmapSize);
+        uncachedPixelsSize = uncachedPixels ? bitmapSize : 0;
+        if (!uncachedPixels) {
+            DEBUG_FUNCTION_LINE_ERR("Failed to allocate memory for glyph");
+            return nullptr;
+        }
+    }
+    uncachedGlyph           = {};
+    uncachedGlyph.codepoint = codepoint;
+    uncachedGlyph.fontSize  = size;
+    uncachedGlyph.pixels    = uncachedPixels.get();
+    return &uncachedGlyph;
+}
+
+/**
+ * Moves a glyph the prewarm worker has finished into the glyph cache. Returns nullptr if it isn't ready (yet).
+ */
+static const CachedGlyph *takePrewarmedGlyph(uint32_t codepoint, uint32_t size) {
+    if (!prewarmWorker) {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < prewarmWorker->slotCount; i++) {
+        PrewarmSlot &slot = prewarmWorker->slots[i];
+        if (slot.glyph.codepoint != codepoint || slot.glyph.fontSize != size) {
+            continue;
+        }
+        if (!slot.ready.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        // the slot belongs to the worker, which may be gone after the next screen change, so the glyph always gets copied
+        uint32_t bitmapSize = (uint32_t) (slot.glyph.width * slot.glyph.height);
+        CachedGlyph *glyph  = glyphCache ? glyphCache->insert(codepoint, size, bitmapSize) : nullptr;
+        if (!glyph) {
+            glyph = getUncachedGlyph(codepoint, size, bitmapSize);
+            if (!glyph) {
+                return nullptr;
             }
         }
+        uint8_t *pixels = glyph->pixels;
+        *glyph          = slot.glyph;
+        glyph->pixels   = pixels;
+        if (bitmapSize > 0) {
+            memcpy(pixels, slot.glyph.pixels, bitmapSize);
+        }
+        return glyph;
     }
+    return nullptr;
 }
 
-uint32_t DrawUtils::getTextWidth(const char *string) {
-    auto *buffer = new wchar_t[strlen(string) + 1];
+/**
+ * Returns the glyph of a codepoint in the given font size, renders and caches it if needed.
+ * The returned glyph is only valid until the next call.
+ */
+static const CachedGlyph *getGlyph(uint32_t codepoint, uint32_t size) {
+    if (glyphCache) {
+        const CachedGlyph *cached = glyphCache->find(codepoint, size);
+        if (cached) {
+            return cached;
+        }
+    }
+    const CachedGlyph *prewarmed = takePrewarmedGlyph(codepoint, size);
+    if (prewarmed) {
+        return prewarmed;
+    }
+
+    SFT_Glyph gid; //  unsigned long gid;
+    SFT_GMetrics mtx;
+    if (!loadGlyphMetrics(&pFont, codepoint, size, &gid, &mtx)) {
+        return nullptr;
+    }
 
-    size_t num = mbstowcs(buffer, string, strlen(string));
-    if (num > 0) {
-        buffer[num] = 0;
-    } else {
-        wchar_t *tmp = buffer;
-        while ((*tmp++ = *string++))
-            ;
+    uint32_t bitmapSize = (uint32_t) (((mtx.minWidth + 3) & ~3) * mtx.minHeight);
+    CachedGlyph *glyph  = glyphCache ? glyphCache->insert(codepoint, size, bitmapSize) : nullptr;
+    if (!glyph) {
+        glyph = getUncachedGlyph(codepoint, size, bitmapSize);
+        if (!glyph) {
+            return nullptr;
+        }
+    }
+    setGlyphMetrics(glyph, mtx);
+
+    if (!rasterizeGlyph(&pFont, sdfEnabled ? sdfCache : nullptr, gid, glyph)) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to render glyph");
+        if (glyph != &uncachedGlyph) {
+            glyphCache->remove(codepoint, size);
+        }
+        return nullptr;
     }
+    // back to the requested size
+    pFont.xScale = size;
+    pFont.yScale = size;
+    return glyph;
+}
 
-    uint32_t width = getTextWidth(buffer);
-    delete[] buffer;
+/**
+ * Walks a null-terminated wide string like Utf8Decoder walks UTF-8.
+ */
+class WideStringDecoder {
+public:
+    explicit WideStringDecoder(const wchar_t *str) : mStr(str) {}
 
+    bool next(uint32_t &codepoint) {
+        if (*mStr == 0) {
+            return false;
+        }
+        codepoint = (uint32_t) *mStr++;
+        return true;
+    }
+
+private:
+    const wchar_t *mStr;
+};
+
+template<typename Decoder>
+static uint32_t measureText(Decoder decoder) {
+    uint32_t width = 0;
+    uint32_t codepoint;
+    while (decoder.next(codepoint)) {
+        const CachedGlyph *glyph = getGlyph(codepoint, fontSize);
+        if (glyph) {
+            width += (int32_t) glyph->advanceWidth;
+        }
+    }
     return width;
 }
 
+template<typename Decoder>
+static void drawText(uint32_t x, uint32_t y, Decoder decoder, TextAlign align) {
+    auto penX = (int32_t) x;
+    auto penY = (int32_t) y;
+
+    if (align == TEXT_ALIGN_RIGHT) {
+        penX -= measureText(decoder);
+    } else if (align == TEXT_ALIGN_CENTER) {
+        penX -= measureText(decoder) / 2;
+    }
+
+    uint32_t codepoint;
+    while (decoder.next(codepoint)) {
+        const CachedGlyph *glyph = getGlyph(codepoint, fontSize);
+        if (!glyph) {
+            continue;
+        }
+
+        if (codepoint == '\n') {
+            penY += glyph->minHeight;
+            penX = x;
+            continue;
+        }
+
+        if (glyph->width > 0 && glyph->height > 0) {
+            SFT_Image img = {
+                    .pixels = glyph->pixels,
+                    .width  = glyph->width,
+                    .height = glyph->height,
+            };
+            draw_freetype_bitmap(&img, (int32_t) (penX + glyph->leftSideBearing), penY + glyph->yOffset);
+        }
+        penX += (int32_t) glyph->advanceWidth;
+    }
+}
+
+void DrawUtils::print(uint32_t x, uint32_t y, std::string_view string, TextAlign align) {
+    drawText(x, y, Utf8Decoder(string), align);
+}
+
+void DrawUtils::print(uint32_t x, uint32_t y, const wchar_t *string, TextAlign align) {
+    drawText(x, y, WideStringDecoder(string), align);
+}
+
+uint32_t DrawUtils::getTextWidth(std::string_view string) {
+    return measureText(Utf8Decoder(string));
+}
+
 uint32_t DrawUtils::getTextWidth(const wchar_t *string) {
-    uint32_t width = 0;
+    return measureText(WideStringDecoder(string));
+}
 
-    for (; *string; string++) {
-        SFT_Glyph gid; //  unsigned long gid;
-        if (sft_lookup(&pFont, *string, &gid) >= 0) {
-            SFT_GMetrics mtx;
-            if (sft_gmetrics(&pFont, gid, &mtx) < 0) {
-                DEBUG_FUNCTION_LINE_ERR("bad glyph metrics");
-            }
-            width += (int32_t) mtx.advanceWidth;
+void TextRun::set(std::string_view string, uint32_t fontSize) {
+    if (mLaidOut && mFontSize == fontSize && mText == string) {
+        return;
+    }
+    mText.assign(string.data(), string.size());
+    mFontSize = fontSize;
+    mLaidOut  = true;
+    mWidth    = 0;
+    mBounds   = {};
+    mGlyphs.clear();
+
+    Utf8Decoder decoder(mText);
+    uint32_t codepoint;
+    int32_t penX = 0;
+    int32_t penY = 0;
+    while (decoder.next(codepoint)) {
+        const CachedGlyph *glyph = getGlyph(codepoint, fontSize);
+        if (!glyph) {
+            continue;
+        }
+        if (codepoint == '\n') {
+            penY += glyph->minHeight;
+            penX = 0;
+            continue;
         }
+        if (glyph->width > 0 && glyph->height > 0) {
+            PositionedGlyph positioned = {codepoint, (int32_t) (penX + glyph->leftSideBearing), penY + glyph->yOffset};
+            mGlyphs.push_back(positioned);
+            mBounds = mBounds.united(Rect(positioned.x, positioned.y, glyph->width, glyph->height));
+        }
+        penX += (int32_t) glyph->advanceWidth;
+        if (penX > (int32_t) mWidth) {
+            mWidth = penX;
+        }
+    }
+}
+
+int32_t TextRun::getStartX(uint32_t x, TextAlign align) const {
+    switch (align) {
+        case TEXT_ALIGN_CENTER:
+            return (int32_t) x - (int32_t) (mWidth / 2);
+        case TEXT_ALIGN_RIGHT:
+            return (int32_t) x - (int32_t) mWidth;
+        default:
+            return (int32_t) x;
     }
+}
 
-    return (uint32_t) width;
+Rect TextRun::getBounds(uint32_t x, uint32_t y, TextAlign align) const {
+    if (mBounds.empty()) {
+        return {};
+    }
+    int32_t startX = getStartX(x, align);
+    return Rect(startX + mBounds.x0, (int32_t) y + mBounds.y0, mBounds.x1 - mBounds.x0, mBounds.y1 - mBounds.y0);
+}
+
+void DrawUtils::print(uint32_t x, uint32_t y, const TextRun &run, TextAlign align) {
+    int32_t startX = run.getStartX(x, align);
+    for (const auto &positioned : run.mGlyphs) {
+        // glyphs are usually still cached from the layout
+        const CachedGlyph *glyph = getGlyph(positioned.codepoint, run.mFontSize);
+        if (!glyph) {
+            continue;
+        }
+        SFT_Image img = {
+                .pixels = glyph->pixels,
+                .width  = glyph->width,
+                .height = glyph->height,
+        };
+        draw_freetype_bitmap(&img, startX + positioned.x, (int32_t) y + positioned.y);
+    }
 }
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "schrift.h"
+#include <coreinit/screen.h>
 #include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 // visible screen sizes
 #define SCREEN_WIDTH  854
@@ -28,20 +33,270 @@ union Color {
     };
 };
 
+struct Rect {
+    Rect() = default;
+
+    Rect(int32_t x, int32_t y, int32_t w, int32_t h) : x0(x), y0(y), x1(x + w), y1(y + h) {}
+
+    [[nodiscard]] bool empty() const { return x0 >= x1 || y0 >= y1; }
+
+    [[nodiscard]] bool intersects(const Rect &other) const {
+        return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1;
+    }
+
+    [[nodiscard]] Rect united(const Rect &other) const {
+        if (empty()) {
+            return other;
+        } else if (other.empty()) {
+            return *this;
+        }
+        Rect res;
+        res.x0 = x0 < other.x0 ? x0 : other.x0;
+        res.y0 = y0 < other.y0 ? y0 : other.y0;
+        res.x1 = x1 > other.x1 ? x1 : other.x1;
+        res.y1 = y1 > other.y1 ? y1 : other.y1;
+        return res;
+    }
+
+    bool operator==(const Rect &other) const = default;
+
+    int32_t x0 = 0;
+    int32_t y0 = 0;
+    int32_t x1 = 0;
+    int32_t y1 = 0;
+};
+
+/**
+ * Snapshot of the whole logical screen, e.g. the parts of a screen that never change.
+ */
+class ScreenLayer {
+public:
+    ScreenLayer() = default;
+
+    ScreenLayer(const ScreenLayer &) = delete;
+
+    ScreenLayer &operator=(const ScreenLayer &) = delete;
+
+    ~ScreenLayer();
+
+    [[nodiscard]] bool isValid() const { return mPixels != nullptr; }
+
+    void release();
+
+private:
+    friend class DrawUtils;
+
+    uint32_t *mPixels = nullptr;
+};
+
+/**
+ * Image that has been decoded once into premultiplied pixels in the framebuffer format, so drawing it every frame
+ * only costs a blit. Decode assets when a screen is set up and draw them with DrawUtils::drawImage.
+ */
+class DecodedImage {
+public:
+    DecodedImage() = default;
+
+    DecodedImage(const DecodedImage &) = delete;
+
+    DecodedImage &operator=(const DecodedImage &) = delete;
+
+    ~DecodedImage();
+
+    /**
+     * Decodes a PNG of any color type and bit depth. Returns false and leaves the image empty on errors.
+     */
+    bool decodePNG(const uint8_t *data, uint32_t size);
+
+    /**
+     * Copies pixels with straight alpha in the format of Color, e.g. of an image that is generated at runtime.
+     * Returns false and leaves the image empty if it's out of memory.
+     */
+    bool loadPixels(const uint32_t *pixels, uint32_t width, uint32_t height);
+
+    [[nodiscard]] bool isValid() const { return mPixels != nullptr; }
+
+    [[nodiscard]] uint32_t getWidth() const { return mWidth; }
+
+    [[nodiscard]] uint32_t getHeight() const { return mHeight; }
+
+    void release();
+
+private:
+    friend class DrawUtils;
+
+    enum RowType : uint8_t {
+        ROW_TRANSPARENT,
+        ROW_OPAQUE,
+        ROW_BLENDED,
+    };
+
+    bool allocate(uint32_t width, uint32_t height);
+
+    void premultiply();
+
+    uint32_t *mPixels  = nullptr;
+    uint8_t *mRowTypes = nullptr;
+    uint32_t mWidth    = 0;
+    uint32_t mHeight   = 0;
+    uint32_t mStride   = 0; // in pixels, rows start 64 byte aligned
+};
+
+enum TextAlign {
+    TEXT_ALIGN_LEFT,
+    TEXT_ALIGN_CENTER,
+    TEXT_ALIGN_RIGHT,
+};
+
+/**
+ * Text that has been decoded, looked up and measured once. It can be drawn any number of times at any
+ * alignment without measuring it again, so keeping runs around between frames is cheap.
+ */
+class TextRun {
+public:
+    TextRun() = default;
+
+    TextRun(std::string_view string, uint32_t fontSize) { set(string, fontSize); }
+
+    /**
+     * Lays out the text in the given font size. Does nothing if neither changed since the last call.
+     */
+    void set(std::string_view string, uint32_t fontSize);
+
+    [[nodiscard]] const std::string &getText() const { return mText; }
+
+    [[nodiscard]] uint32_t getFontSize() const { return mFontSize; }
+
+    [[nodiscard]] uint32_t getWidth() const { return mWidth; }
+
+    /**
+     * Area covered by the glyphs when the run is drawn at the given position.
+     */
+    [[nodiscard]] Rect getBounds(uint32_t x, uint32_t y, TextAlign align = TEXT_ALIGN_LEFT) const;
+
+private:
+    friend class DrawUtils;
+
+    struct PositionedGlyph {
+        uint32_t codepoint;
+        // top left corner of the glyph bitmap relative to the start of the baseline
+        int32_t x;
+        int32_t y;
+    };
+
+    [[nodiscard]] int32_t getStartX(uint32_t x, TextAlign align) const;
+
+    std::string mText;
+    uint32_t mFontSize = 0;
+    bool mLaidOut      = false;
+    uint32_t mWidth    = 0;
+    Rect mBounds       = {};
+    std::vector<PositionedGlyph> mGlyphs;
+};
+
+/**
+ * Text whose glyphs are known to be drawn in the given size soon, see DrawUtils::initFont.
+ */
+struct GlyphPrewarm {
+    std::string_view text;
+    uint32_t fontSize;
+};
+
 class DrawUtils {
 public:
     static void ClearSavedFrameBuffers();
 
     static void *InitOSScreen();
 
+    /**
+     * Draws into plain memory instead of OSScreen, e.g. to run the menus headless. Has to be set before
+     * InitOSScreen, which then only allocates the buffers, endDraw swaps them instead of flipping.
+     */
+    static void setMemoryBackend(bool enabled);
+
+    static bool isMemoryBackend();
+
+    /**
+     * Size of the double buffered screen buffer, as OSScreenGetBufferSizeEx or for the memory backend.
+     */
+    static uint32_t getBufferSize(OSScreenID screen);
+
     static void initBuffers(void *tvBuffer, uint32_t tvSize, void *drcBuffer, uint32_t drcSize);
 
+    static void deinitBuffers();
+
+    /**
+     * Frames finished since initBuffers.
+     */
+    static uint32_t getFrameCount();
+
+    /**
+     * Time spent between beginDraw and endDraw, summed up over all frames since initBuffers, in microseconds.
+     */
+    static uint64_t getDrawTimeUs();
+
+    /**
+     * Hash over the 854x480 DRC content of every frame the memory backend finished since initBuffers, to compare runs
+     * of the same input. Stays 0 with OSScreen.
+     */
+    static uint32_t getFramesHash();
+
+    /**
+     * When enabled, everything is drawn into a single 854x480 canvas which is copied to the DRC
+     * and upscaled to the TV in endDraw. Can be toggled between frames.
+     */
+    static void setCanvasEnabled(bool enabled);
+
+    static bool isCanvasEnabled();
+
+    /**
+     * Applies the render settings of a config file, if it exists. Each line is "<setting>=0" or "<setting>=1":
+     * - canvas: draw into the 854x480 canvas, see setCanvasEnabled.
+     * - sdf_text: resample glyphs from distance fields, see setSdfTextEnabled.
+     * Meant to be called once at boot, before the first screen.
+     */
+    static void loadRenderSettings(const std::string &path);
+
     static void beginDraw();
 
     static void endDraw();
 
+    /**
+     * Ends a frame in which only the given regions changed since the last one. With the canvas only these regions are
+     * copied to the screen buffers, plus whatever the back buffer missed in the frame before.
+     */
+    static void endDraw(std::span<const Rect> dirty);
+
     static void clear(Color col);
 
+    /**
+     * Restricts all drawing (including clear) to the given rectangle until resetClipRect is called.
+     */
+    static void setClipRect(const Rect &rect);
+
+    static void resetClipRect();
+
+    /**
+     * Copies the content of the current frame into the layer.
+     */
+    static bool captureLayer(ScreenLayer &layer);
+
+    /**
+     * Restores a captured layer with a bulk copy. Only the clip rect is restored.
+     */
+    static void drawLayer(const ScreenLayer &layer);
+
+    /**
+     * Returns true if the buffer we are drawing into in the current frame was last drawn by the same owner,
+     * so only the parts that changed since then need to be redrawn. Must be called after beginDraw.
+     */
+    static bool claimTarget(const void *owner);
+
+    /**
+     * Identifies the buffer we are drawing into in the current frame. 0 and 1 are the two screen buffers, 2 is the canvas.
+     */
+    static uint32_t getTargetIndex();
+
     static void drawPixel(uint32_t x, uint32_t y, Color col) { drawPixel(x, y, col.r, col.g, col.b, col.a); }
 
     static void drawPixel(uint32_t x, uint32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a);
@@ -52,25 +307,71 @@ public:
 
     static void drawBitmap(uint32_t x, uint32_t y, uint32_t target_width, uint32_t target_height, const uint8_t *data);
 
-    static void drawPNG(uint32_t x, uint32_t y, const uint8_t *data);
+    /**
+     * Decodes and draws a PNG of the given size in bytes, e.g. of an embedded asset. Screens that draw the same image
+     * more than once should keep a DecodedImage instead.
+     */
+    static void drawPNG(uint32_t x, uint32_t y, const uint8_t *data, uint32_t size);
+
+    /**
+     * Draws a decoded image clipped to the clip rect. Opaque rows get copied, only rows with translucent pixels
+     * are blended.
+     */
+    static void drawImage(uint32_t x, uint32_t y, const DecodedImage &image);
 
-    static bool initFont();
+    /**
+     * Loads the system font. The glyphs of the prewarm set get rendered on another core in the background,
+     * glyphs that are drawn before the worker got to them are rendered right away as usual.
+     */
+    static bool initFont(std::span<const GlyphPrewarm> prewarm = {});
+
+    /**
+     * Replaces the prewarm set of initFont, e.g. when the next screen reuses the font.
+     */
+    static void prewarmGlyphs(std::span<const GlyphPrewarm> prewarm);
 
     static void deinitFont();
 
+    /**
+     * Keeps the rendered glyphs in the given file between boots, see initFont. Must be set before initFont, without a
+     * file every boot starts with an empty glyph cache.
+     */
+    static void setGlyphCacheFile(const std::string &path);
+
+    /**
+     * Keeps the rendered glyphs of all font sizes in an LRU cache, so repeated text only costs a blit. Enabled by
+     * default, without it every glyph gets rendered again each time it's drawn. Takes effect with the next initFont.
+     */
+    static void setGlyphCacheEnabled(bool enabled);
+
     static void setFontSize(uint32_t size);
 
+    /**
+     * When enabled, each glyph is rendered once as a distance field and the font sizes up to 72 are resampled
+     * from it, instead of rasterizing the outline again for each size. Enabled by default.
+     */
+    static void setSdfTextEnabled(bool enabled);
+
+    static bool isSdfTextEnabled();
+
     static void setFontColor(Color col);
 
-    static void print(uint32_t x, uint32_t y, const char *string, bool alignRight = false);
+    static void print(uint32_t x, uint32_t y, std::string_view string, TextAlign align = TEXT_ALIGN_LEFT);
 
-    static void print(uint32_t x, uint32_t y, const wchar_t *string, bool alignRight = false);
+    static void print(uint32_t x, uint32_t y, const wchar_t *string, TextAlign align = TEXT_ALIGN_LEFT);
 
-    static uint32_t getTextWidth(const char *string);
+    static uint32_t getTextWidth(std::string_view string);
 
     static uint32_t getTextWidth(const wchar_t *string);
 
+    /**
+     * Draws a run in its own font size, using the current font color.
+     */
+    static void print(uint32_t x, uint32_t y, const TextRun &run, TextAlign align = TEXT_ALIGN_LEFT);
+
 private:
+    static void updateTargets();
+
     static bool isBackBuffer;
 
     static uint8_t *tvBuffer;
@@ -0,0 +1,45 @@
+#include "FrameScheduler.h"
+#include "InputRecorder.h"
+#include "logger.h"
+#include <coreinit/thread.h>
+
+FrameScheduler::FrameScheduler(uint32_t framesPerSecond) {
+    mFrameDuration = OSSecondsToTicks(1) / framesPerSecond;
+}
+
+FrameScheduler::~FrameScheduler() {
+    DEBUG_FUNCTION_LINE("Rendered %d frames, skipped %d frames", mFramesRendered, mFramesSkipped);
+}
+
+void FrameScheduler::waitForNextFrame() {
+    InputRecorder::nextFrame();
+
+    OSTime now = OSGetTime();
+    if (mNextFrame == 0 || now - mNextFrame > mFrameDuration) {
+        // first frame or we fell behind, don't try to catch up
+        mNextFrame = now;
+    } else if (mNextFrame > now) {
+        OSSleepTicks(mNextFrame - now);
+    }
+    mNextFrame += mFrameDuration;
+}
+
+void FrameScheduler::requestRedrawAt(OSTime time) {
+    if (mRedrawAt == 0 || time < mRedrawAt) {
+        mRedrawAt = time;
+    }
+}
+
+bool FrameScheduler::shouldRender() {
+    if (mRedrawAt != 0 && OSGetTime() >= mRedrawAt) {
+        mRedrawAt        = 0;
+        mRedrawRequested = true;
+    }
+    if (!mRedrawRequested) {
+        mFramesSkipped++;
+        return false;
+    }
+    mRedrawRequested = false;
+    mFramesRendered++;
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <coreinit/time.h>
+#include <cstdint>
+
+/**
+ * Paces the menu loops and decides whether a frame needs to be rendered.
+ *
+ * A frame is only rendered after requestRedraw (input, state changes) or when a timed redraw is due.
+ * Between frames waitForNextFrame sleeps until the next frame slot, so an idle screen doesn't keep a core busy.
+ */
+class FrameScheduler {
+public:
+    explicit FrameScheduler(uint32_t framesPerSecond = 60);
+
+    ~FrameScheduler();
+
+    void waitForNextFrame();
+
+    void requestRedraw() { mRedrawRequested = true; }
+
+    /**
+     * Requests a redraw once the given time has been reached, e.g. for countdowns.
+     */
+    void requestRedrawAt(OSTime time);
+
+    /**
+     * Returns true if the current frame should be rendered. Consumes pending redraw requests.
+     */
+    bool shouldRender();
+
+    [[nodiscard]] uint32_t getFramesRendered() const { return mFramesRendered; }
+
+    [[nodiscard]] uint32_t getFramesSkipped() const { return mFramesSkipped; }
+
+private:
+    OSTime mFrameDuration;
+    OSTime mNextFrame        = 0;
+    OSTime mRedrawAt         = 0;
+    bool mRedrawRequested    = true;
+    uint32_t mFramesRendered = 0;
+    uint32_t mFramesSkipped  = 0;
+};
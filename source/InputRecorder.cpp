@@ -0,0 +1,178 @@
+#include "InputRecorder.h"
+#include "logger.h"
+#include "utils.h"
+#include <coreinit/time.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define INPUT_RECORDING_MAGIC   0x49524331 // "IRC1"
+#define INPUT_RECORDING_VERSION 2
+
+struct InputRecordingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t recordCount;
+};
+
+struct InputRecord {
+    uint32_t frame;
+    uint32_t timeUs; // since the recording started
+    uint32_t trigger;
+    uint32_t hold;
+    uint32_t release;
+};
+
+static std::vector<InputRecord> records;
+static bool recording       = false;
+static bool replaying       = false;
+static uint32_t frame       = 0;
+static uint32_t frameCount  = 0;
+static uint32_t nextRecord  = 0;
+static uint32_t currentHold = 0;
+static OSTime startTime     = 0;
+// input of the current frame, merged from every read while recording, the edges go to the first read while replaying
+static InputUtils::InputData frameInput = {};
+
+void InputRecorder::startRecording() {
+    records.clear();
+    recording   = true;
+    replaying   = false;
+    frame       = 0;
+    currentHold = 0;
+    frameInput  = {};
+    startTime   = OSGetSystemTime();
+}
+
+// stores the input of the current frame if anything happened in it
+static void commitFrame() {
+    if (frameInput.trigger != 0 || frameInput.release != 0 || frameInput.hold != currentHold) {
+        records.push_back({
+                .frame   = frame,
+                .timeUs  = (uint32_t) OSTicksToMicroseconds(OSGetSystemTime() - startTime),
+                .trigger = frameInput.trigger,
+                .hold    = frameInput.hold,
+                .release = frameInput.release,
+        });
+        currentHold = frameInput.hold;
+    }
+    frameInput      = {};
+    frameInput.hold = currentHold;
+}
+
+// takes the input of the current frame from the recording, if it has any
+static void loadFrame() {
+    frameInput = {};
+    if (nextRecord < records.size() && records[nextRecord].frame == frame) {
+        const InputRecord &record = records[nextRecord++];
+        frameInput.trigger        = record.trigger;
+        frameInput.release        = record.release;
+        currentHold               = record.hold;
+    }
+    frameInput.hold = currentHold;
+    if (frame == frameCount) {
+        DEBUG_FUNCTION_LINE_INFO("Input recording is over after %d frames", frameCount);
+    }
+}
+
+bool InputRecorder::saveRecording(const std::string &path) {
+    if (!recording) {
+        return false;
+    }
+    commitFrame();
+    frame++;
+    recording = false;
+
+    InputRecordingHeader header = {
+            .magic       = INPUT_RECORDING_MAGIC,
+            .version     = INPUT_RECORDING_VERSION,
+            .frameCount  = frame,
+            .recordCount = (uint32_t) records.size(),
+    };
+    std::vector<uint8_t> buffer(sizeof(header) + records.size() * sizeof(InputRecord));
+    memcpy(buffer.data(), &header, sizeof(header));
+    if (!records.empty()) {
+        memcpy(buffer.data() + sizeof(header), records.data(), records.size() * sizeof(InputRecord));
+    }
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to open %s", path.c_str());
+        return false;
+    }
+    bool res = fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+    fclose(f);
+    if (!res) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to write %s", path.c_str());
+        return false;
+    }
+    DEBUG_FUNCTION_LINE_INFO("Recorded %d frames of input into %s", frame, path.c_str());
+    return true;
+}
+
+bool InputRecorder::startReplay(const std::string &path) {
+    std::vector<uint8_t> buffer;
+    if (!LoadFileIntoBuffer(path, buffer)) {
+        return false;
+    }
+    InputRecordingHeader header;
+    if (buffer.size() < sizeof(header)) {
+        DEBUG_FUNCTION_LINE_WARN("Input recording is truncated");
+        return false;
+    }
+    memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION ||
+        buffer.size() - sizeof(header) != (size_t) header.recordCount * sizeof(InputRecord)) {
+        DEBUG_FUNCTION_LINE_WARN("Ignoring invalid input recording %s", path.c_str());
+        return false;
+    }
+
+    records.resize(header.recordCount);
+    if (header.recordCount > 0) {
+        memcpy(records.data(), buffer.data() + sizeof(header), records.size() * sizeof(InputRecord));
+    }
+    recording   = false;
+    replaying   = true;
+    frame       = 0;
+    frameCount  = header.frameCount;
+    nextRecord  = 0;
+    currentHold = 0;
+    loadFrame();
+    DEBUG_FUNCTION_LINE_INFO("Replaying %d frames of input from %s", frameCount, path.c_str());
+    return true;
+}
+
+bool InputRecorder::isRecording() {
+    return recording;
+}
+
+bool InputRecorder::isReplaying() {
+    return replaying;
+}
+
+void InputRecorder::record(const InputUtils::InputData &input) {
+    if (!recording) {
+        return;
+    }
+    frameInput.trigger |= input.trigger;
+    frameInput.release |= input.release;
+    frameInput.hold = input.hold;
+}
+
+InputUtils::InputData InputRecorder::replay() {
+    InputUtils::InputData input = frameInput;
+    frameInput.trigger          = 0;
+    frameInput.release          = 0;
+    return input;
+}
+
+void InputRecorder::nextFrame() {
+    if (recording) {
+        commitFrame();
+        frame++;
+    } else if (replaying) {
+        frame++;
+        loadFrame();
+    }
+}
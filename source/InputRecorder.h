@@ -0,0 +1,44 @@
+#pragma once
+
+#include "InputUtils.h"
+#include <string>
+
+#define INPUT_RECORDING_PATH "fs:/vol/external01/wiiu/autoboot_input.rec"
+
+/**
+ * Records the input InputUtils::getControllerInput returned in each frame, or plays such a recording back instead
+ * of reading the controllers.
+ *
+ * A frame ends with nextFrame, which FrameScheduler calls once per frame of a menu loop. Everything read within a
+ * frame is merged, so it doesn't matter how often a frame reads the input, e.g. for the pair screen. Only frames
+ * with a press, a release or a change of the held buttons are stored. Playback goes by frame, not by time, so a
+ * menu sees exactly the same input on every run no matter how long its frames take.
+ */
+class InputRecorder {
+public:
+    static void startRecording();
+
+    /**
+     * Stops recording and writes everything recorded so far with a single write.
+     */
+    static bool saveRecording(const std::string &path);
+
+    static bool startReplay(const std::string &path);
+
+    [[nodiscard]] static bool isRecording();
+
+    [[nodiscard]] static bool isReplaying();
+
+    static void record(const InputUtils::InputData &input);
+
+    /**
+     * Input of the current frame of the recording. Only the first read of a frame gets its presses and releases.
+     * Once the recording is over, nothing is pressed anymore.
+     */
+    static InputUtils::InputData replay();
+
+    /**
+     * Moves recording or playback to the next frame.
+     */
+    static void nextFrame();
+};
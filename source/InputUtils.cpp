@@ -1,140 +1,467 @@
 #include "InputUtils.h"
+#include "InputRecorder.h"
+#include "LatencyMonitor.h"
+#include "logger.h"
+#include "utils.h"
+#include "utils/ButtonLayouts.h"
+#include "utils/ButtonRemap.h"
+#include "utils/InputSampleRing.h"
+#include <atomic>
 #include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <cstdio>
 #include <padscore/kpad.h>
 #include <padscore/wpad.h>
+#include <span>
+#include <string_view>
 #include <vpad/input.h>
 
-uint32_t remapWiiMoteButtons(uint32_t buttons) {
-    uint32_t convButtons = 0;
-
-    if (buttons & WPAD_BUTTON_LEFT)
-        convButtons |= VPAD_BUTTON_LEFT;
-
-    if (buttons & WPAD_BUTTON_RIGHT)
-        convButtons |= VPAD_BUTTON_RIGHT;
-
-    if (buttons & WPAD_BUTTON_DOWN)
-        convButtons |= VPAD_BUTTON_DOWN;
-
-    if (buttons & WPAD_BUTTON_UP)
-        convButtons |= VPAD_BUTTON_UP;
-
-    if (buttons & WPAD_BUTTON_PLUS)
-        convButtons |= VPAD_BUTTON_PLUS;
-
-    if (buttons & WPAD_BUTTON_2)
-        convButtons |= VPAD_BUTTON_Y;
-
-    if (buttons & WPAD_BUTTON_1)
-        convButtons |= VPAD_BUTTON_X;
-
-    if (buttons & WPAD_BUTTON_B)
-        convButtons |= VPAD_BUTTON_B;
+#define KPAD_CHANNEL_COUNT      4
+#define VPAD_MAX_READ_SAMPLES   16
+#define FIRST_SAMPLE_TIMEOUT_MS 100
+// Edges that queued up while nobody was reading input, e.g. during the quick start, are not reported
+#define MAX_EDGE_AGE_MS         250
+#define STICK_PRESS_THRESHOLD   0.5f
+#define STICK_RELEASE_THRESHOLD 0.3f
+
+struct InputSample {
+    InputUtils::InputData data;
+    OSTime time;
+};
+
+// Each source has its own ring, so every ring has exactly one sampling callback writing to it
+struct SampleSource {
+    InputSampleRing<InputSample, 64> ring;
+    // updated even when the ring is full, so the hold state never goes stale
+    std::atomic<uint32_t> hold = 0;
+    // kept up to date by the connect callback, disconnected channels are not read at all
+    std::atomic<bool> connected = true;
+    // d-pad directions the stick is held in, only used by the sampling callback
+    uint32_t stickHold = 0;
+};
+
+static SampleSource vpadSource;
+static SampleSource kpadSources[KPAD_CHANNEL_COUNT];
+
+struct ButtonName {
+    const char *name;
+    uint32_t mask;
+};
+
+static constexpr ButtonName VPAD_BUTTON_NAMES[] = {
+        {"A", VPAD_BUTTON_A},
+        {"B", VPAD_BUTTON_B},
+        {"X", VPAD_BUTTON_X},
+        {"Y", VPAD_BUTTON_Y},
+        {"LEFT", VPAD_BUTTON_LEFT},
+        {"RIGHT", VPAD_BUTTON_RIGHT},
+        {"UP", VPAD_BUTTON_UP},
+        {"DOWN", VPAD_BUTTON_DOWN},
+        {"ZL", VPAD_BUTTON_ZL},
+        {"ZR", VPAD_BUTTON_ZR},
+        {"L", VPAD_BUTTON_L},
+        {"R", VPAD_BUTTON_R},
+        {"PLUS", VPAD_BUTTON_PLUS},
+        {"MINUS", VPAD_BUTTON_MINUS},
+        {"HOME", VPAD_BUTTON_HOME},
+        {"STICK_L", VPAD_BUTTON_STICK_L},
+        {"STICK_R", VPAD_BUTTON_STICK_R},
+};
+
+static constexpr ButtonName WIIMOTE_BUTTON_NAMES[] = {
+        {"LEFT", WPAD_BUTTON_LEFT},
+        {"RIGHT", WPAD_BUTTON_RIGHT},
+        {"DOWN", WPAD_BUTTON_DOWN},
+        {"UP", WPAD_BUTTON_UP},
+        {"PLUS", WPAD_BUTTON_PLUS},
+        {"2", WPAD_BUTTON_2},
+        {"1", WPAD_BUTTON_1},
+        {"B", WPAD_BUTTON_B},
+        {"A", WPAD_BUTTON_A},
+        {"MINUS", WPAD_BUTTON_MINUS},
+        {"Z", WPAD_BUTTON_Z},
+        {"C", WPAD_BUTTON_C},
+        {"HOME", WPAD_BUTTON_HOME},
+};
+
+static constexpr ButtonName CLASSIC_BUTTON_NAMES[] = {
+        {"UP", WPAD_CLASSIC_BUTTON_UP},
+        {"LEFT", WPAD_CLASSIC_BUTTON_LEFT},
+        {"ZR", WPAD_CLASSIC_BUTTON_ZR},
+        {"X", WPAD_CLASSIC_BUTTON_X},
+        {"A", WPAD_CLASSIC_BUTTON_A},
+        {"Y", WPAD_CLASSIC_BUTTON_Y},
+        {"B", WPAD_CLASSIC_BUTTON_B},
+        {"ZL", WPAD_CLASSIC_BUTTON_ZL},
+        {"R", WPAD_CLASSIC_BUTTON_R},
+        {"PLUS", WPAD_CLASSIC_BUTTON_PLUS},
+        {"HOME", WPAD_CLASSIC_BUTTON_HOME},
+        {"MINUS", WPAD_CLASSIC_BUTTON_MINUS},
+        {"L", WPAD_CLASSIC_BUTTON_L},
+        {"DOWN", WPAD_CLASSIC_BUTTON_DOWN},
+        {"RIGHT", WPAD_CLASSIC_BUTTON_RIGHT},
+};
+
+static constexpr ButtonName PRO_BUTTON_NAMES[] = {
+        {"UP", WPAD_PRO_BUTTON_UP},
+        {"LEFT", WPAD_PRO_BUTTON_LEFT},
+        {"ZR", WPAD_PRO_TRIGGER_ZR},
+        {"X", WPAD_PRO_BUTTON_X},
+        {"A", WPAD_PRO_BUTTON_A},
+        {"Y", WPAD_PRO_BUTTON_Y},
+        {"B", WPAD_PRO_BUTTON_B},
+        {"ZL", WPAD_PRO_TRIGGER_ZL},
+        {"R", WPAD_PRO_TRIGGER_R},
+        {"PLUS", WPAD_PRO_BUTTON_PLUS},
+        {"HOME", WPAD_PRO_BUTTON_HOME},
+        {"MINUS", WPAD_PRO_BUTTON_MINUS},
+        {"L", WPAD_PRO_TRIGGER_L},
+        {"DOWN", WPAD_PRO_BUTTON_DOWN},
+        {"RIGHT", WPAD_PRO_BUTTON_RIGHT},
+        {"STICK_R", WPAD_PRO_BUTTON_STICK_R},
+        {"STICK_L", WPAD_PRO_BUTTON_STICK_L},
+};
+
+static constexpr ButtonRemap DEFAULT_WIIMOTE_REMAP(WIIMOTE_BINDINGS);
+static constexpr ButtonRemap DEFAULT_CLASSIC_REMAP(CLASSIC_BINDINGS);
+static constexpr ButtonRemap DEFAULT_PRO_REMAP(PRO_BINDINGS);
+
+static_assert(DEFAULT_WIIMOTE_REMAP.map(WPAD_BUTTON_2 | WPAD_BUTTON_A | WPAD_BUTTON_Z) == (VPAD_BUTTON_Y | VPAD_BUTTON_A));
+static_assert(DEFAULT_CLASSIC_REMAP.map(WPAD_CLASSIC_BUTTON_ZR | WPAD_CLASSIC_BUTTON_RIGHT) == (VPAD_BUTTON_ZR | VPAD_BUTTON_RIGHT));
+static_assert(DEFAULT_PRO_REMAP.map(WPAD_PRO_BUTTON_STICK_L | WPAD_PRO_BUTTON_HOME) == (VPAD_BUTTON_STICK_L | VPAD_BUTTON_HOME));
+
+/**
+ * Button layout of a controller type. The sampling callbacks read the active remap, which is one of the defaults
+ * until loadButtonBindings has installed a customized copy.
+ */
+struct ControllerLayout {
+    const char *name;
+    std::span<const ButtonName> buttons;
+    std::atomic<const ButtonRemap *> active;
+    ButtonRemap custom;
+};
+
+enum ControllerLayoutType {
+    LAYOUT_WIIMOTE,
+    LAYOUT_CLASSIC,
+    LAYOUT_PRO,
+    LAYOUT_COUNT,
+};
+
+static ControllerLayout layouts[LAYOUT_COUNT] = {
+        {"wiimote", WIIMOTE_BUTTON_NAMES, &DEFAULT_WIIMOTE_REMAP, {}},
+        {"classic", CLASSIC_BUTTON_NAMES, &DEFAULT_CLASSIC_REMAP, {}},
+        {"pro", PRO_BUTTON_NAMES, &DEFAULT_PRO_REMAP, {}},
+};
+
+static InputUtils::InputData remapButtons(ControllerLayoutType type, uint32_t trigger, uint32_t hold, uint32_t release) {
+    const ButtonRemap *remap = layouts[type].active.load(std::memory_order_acquire);
+    return {remap->map(trigger), remap->map(hold), remap->map(release)};
+}
 
-    if (buttons & WPAD_BUTTON_A)
-        convButtons |= VPAD_BUTTON_A;
+static InputUtils::InputData remapKPADStatus(const KPADStatus &status) {
+    switch (status.extensionType) {
+        case WPAD_EXT_CORE:
+        case WPAD_EXT_NUNCHUK:
+        case WPAD_EXT_MPLUS:
+        case WPAD_EXT_MPLUS_NUNCHUK:
+            return remapButtons(LAYOUT_WIIMOTE, status.trigger, status.hold, status.release);
+        case WPAD_EXT_PRO_CONTROLLER:
+            return remapButtons(LAYOUT_PRO, status.pro.trigger, status.pro.hold, status.pro.release);
+        default:
+            return remapButtons(LAYOUT_CLASSIC, status.classic.trigger, status.classic.hold, status.classic.release);
+    }
+}
 
-    if (buttons & WPAD_BUTTON_MINUS)
-        convButtons |= VPAD_BUTTON_MINUS;
+/**
+ * Turns the Nunchuk or Pro Controller stick into d-pad presses. A direction is pressed past STICK_PRESS_THRESHOLD
+ * and only let go below STICK_RELEASE_THRESHOLD, so a stick resting near the threshold doesn't flicker.
+ */
+static void applyStickDpad(InputUtils::InputData &sample, const KPADStatus &status, uint32_t &stickHold) {
+    KPADVec2D stick = {};
+    if (status.extensionType == WPAD_EXT_NUNCHUK || status.extensionType == WPAD_EXT_MPLUS_NUNCHUK) {
+        stick = status.nunchuk.stick;
+    } else if (status.extensionType == WPAD_EXT_PRO_CONTROLLER) {
+        stick = status.pro.leftStick;
+    }
 
-    if (buttons & WPAD_BUTTON_HOME)
-        convButtons |= VPAD_BUTTON_HOME;
+    auto threshold = [stickHold](uint32_t button) {
+        return (stickHold & button) ? STICK_RELEASE_THRESHOLD : STICK_PRESS_THRESHOLD;
+    };
+    uint32_t dpad = 0;
+    if (stick.x > threshold(VPAD_BUTTON_RIGHT)) {
+        dpad |= VPAD_BUTTON_RIGHT;
+    } else if (stick.x < -threshold(VPAD_BUTTON_LEFT)) {
+        dpad |= VPAD_BUTTON_LEFT;
+    }
+    if (stick.y > threshold(VPAD_BUTTON_UP)) {
+        dpad |= VPAD_BUTTON_UP;
+    } else if (stick.y < -threshold(VPAD_BUTTON_DOWN)) {
+        dpad |= VPAD_BUTTON_DOWN;
+    }
 
-    return convButtons;
+    sample.trigger |= dpad & ~stickHold;
+    sample.release |= stickHold & ~dpad;
+    sample.hold |= dpad;
+    stickHold = dpad;
 }
 
-uint32_t remapClassicButtons(uint32_t buttons) {
-    uint32_t convButtons = 0;
-
-    if (buttons & WPAD_CLASSIC_BUTTON_LEFT)
-        convButtons |= VPAD_BUTTON_LEFT;
-
-    if (buttons & WPAD_CLASSIC_BUTTON_RIGHT)
-        convButtons |= VPAD_BUTTON_RIGHT;
+/**
+ * Adds a newer sample to a batch. Returns false instead if the batch already has a press or a release of one of
+ * the buttons, so a fast double press is kept as two batches.
+ */
+static bool coalesceSample(InputUtils::InputData &batch, const InputUtils::InputData &sample) {
+    if ((batch.trigger & sample.trigger) != 0 || (batch.release & sample.release) != 0) {
+        return false;
+    }
+    batch.trigger |= sample.trigger;
+    batch.release |= sample.release;
+    batch.hold = sample.hold;
+    batch.samples += sample.samples;
+    return true;
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_DOWN)
-        convButtons |= VPAD_BUTTON_DOWN;
+/**
+ * Queues the samples of one read, oldest first, in as few batches as possible.
+ */
+static void pushSamples(SampleSource &source, const InputUtils::InputData *samples, int32_t count) {
+    if (count <= 0) {
+        return;
+    }
+    OSTime now                  = OSGetSystemTime();
+    InputUtils::InputData batch = {};
+    for (int32_t i = 0; i < count; i++) {
+        if (!coalesceSample(batch, samples[i])) {
+            source.ring.push({batch, now});
+            batch = samples[i];
+        }
+    }
+    source.ring.push({batch, now});
+    source.hold.store(batch.hold, std::memory_order_relaxed);
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_UP)
-        convButtons |= VPAD_BUTTON_UP;
+/**
+ * Takes the queued samples of one controller. Each source gets its own batch, coalescing only makes sense within
+ * the samples of one controller.
+ */
+static InputUtils::InputData drainSamples(SampleSource &source, OSTime now) {
+    InputUtils::InputData inputData = {};
+    source.ring.drain([&inputData, now](const InputSample &sample) {
+        if (now - sample.time > OSMillisecondsToTicks(MAX_EDGE_AGE_MS)) {
+            return true;
+        }
+        // a second press of a button is left for the next frame
+        if (!coalesceSample(inputData, sample.data)) {
+            return false;
+        }
+        if (sample.data.trigger != 0) {
+            LatencyMonitor::inputConsumed(sample.time);
+        }
+        return true;
+    });
+    if (!source.connected.load(std::memory_order_relaxed)) {
+        // let go of everything a controller was holding when it got disconnected
+        inputData.release |= source.hold.exchange(0, std::memory_order_relaxed);
+    }
+    inputData.hold |= source.hold.load(std::memory_order_relaxed);
+    return inputData;
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_PLUS)
-        convButtons |= VPAD_BUTTON_PLUS;
+/**
+ * Adds the input of another controller, so that all of them can be used at the same time.
+ */
+static void mergeInput(InputUtils::InputData &inputData, const InputUtils::InputData &other) {
+    inputData.trigger |= other.trigger;
+    inputData.hold |= other.hold;
+    inputData.release |= other.release;
+    inputData.samples += other.samples;
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_X)
-        convButtons |= VPAD_BUTTON_X;
+static void vpadSamplingCallback(VPADChan chan) {
+    // VPAD returns the newest sample first
+    static VPADStatus vpadStatus[VPAD_MAX_READ_SAMPLES];
+    VPADReadError vpadError = VPAD_READ_UNINITIALIZED;
+    int32_t count           = VPADRead(chan, vpadStatus, VPAD_MAX_READ_SAMPLES, &vpadError);
+    if (count <= 0 || vpadError != VPAD_READ_SUCCESS) {
+        return;
+    }
+    InputUtils::InputData samples[VPAD_MAX_READ_SAMPLES];
+    for (int32_t i = 0; i < count; i++) {
+        const VPADStatus &status = vpadStatus[count - 1 - i];
+        samples[i]               = {status.trigger, status.hold, status.release, 1};
+    }
+    pushSamples(vpadSource, samples, count);
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_Y)
-        convButtons |= VPAD_BUTTON_Y;
+static void kpadSamplingCallback(KPADChan chan) {
+    SampleSource &source = kpadSources[chan];
+    if (!source.connected.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // KPAD returns the newest sample first
+    static KPADStatus kpadStatus[KPAD_CHANNEL_COUNT][KPAD_MAX_READ_BUFS];
+    KPADError kpadError = KPAD_ERROR_UNINITIALIZED;
+    int32_t count       = KPADReadEx(chan, kpadStatus[chan], KPAD_MAX_READ_BUFS, &kpadError);
+    if (count <= 0 || kpadError != KPAD_ERROR_OK) {
+        return;
+    }
+    InputUtils::InputData samples[KPAD_MAX_READ_BUFS];
+    int32_t usable = 0;
+    for (int32_t i = count - 1; i >= 0; i--) {
+        if (kpadStatus[chan][i].extensionType != 0xFF) {
+            samples[usable]         = remapKPADStatus(kpadStatus[chan][i]);
+            samples[usable].samples = 1;
+            applyStickDpad(samples[usable], kpadStatus[chan][i], source.stickHold);
+            usable++;
+        }
+    }
+    pushSamples(source, samples, usable);
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_B)
-        convButtons |= VPAD_BUTTON_B;
+static void kpadConnectCallback(KPADChan chan, int32_t status) {
+    kpadSources[chan].connected.store(status == 0, std::memory_order_relaxed);
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_A)
-        convButtons |= VPAD_BUTTON_A;
+InputUtils::InputData InputUtils::getControllerInput() {
+    OSTime now          = OSGetSystemTime();
+    InputData inputData = drainSamples(vpadSource, now);
+    for (auto &source : kpadSources) {
+        mergeInput(inputData, drainSamples(source, now));
+    }
+    // the controllers are still drained during a replay, so their rings don't overflow
+    if (InputRecorder::isReplaying()) {
+        return InputRecorder::replay();
+    }
+    InputRecorder::record(inputData);
+    return inputData;
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_MINUS)
-        convButtons |= VPAD_BUTTON_MINUS;
+static uint32_t findButton(std::span<const ButtonName> buttons, std::string_view name) {
+    for (const auto &button : buttons) {
+        if (name == button.name) {
+            return button.mask;
+        }
+    }
+    return 0;
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_HOME)
-        convButtons |= VPAD_BUTTON_HOME;
+/**
+ * Parses "<layout>.<button>=<GamePad button>[+<GamePad button>...]" or "<layout>.<button>=none".
+ */
+static bool parseButtonBinding(std::string_view line, ButtonRemap *remaps) {
+    auto dot   = line.find('.');
+    auto equal = line.find('=');
+    if (dot == std::string_view::npos || equal == std::string_view::npos || dot > equal) {
+        return false;
+    }
+    auto layoutName = TrimWhitespace(line.substr(0, dot));
+    auto buttonName = TrimWhitespace(line.substr(dot + 1, equal - dot - 1));
+    auto targets    = TrimWhitespace(line.substr(equal + 1));
 
-    if (buttons & WPAD_CLASSIC_BUTTON_ZR)
-        convButtons |= VPAD_BUTTON_ZR;
+    for (int32_t type = 0; type < LAYOUT_COUNT; type++) {
+        if (layoutName != layouts[type].name) {
+            continue;
+        }
+        uint32_t from = findButton(layouts[type].buttons, buttonName);
+        if (from == 0) {
+            return false;
+        }
+        uint32_t to = 0;
+        if (targets != "none") {
+            while (!targets.empty()) {
+                auto plus     = targets.find('+');
+                uint32_t mask = findButton(VPAD_BUTTON_NAMES, TrimWhitespace(targets.substr(0, plus)));
+                if (mask == 0) {
+                    return false;
+                }
+                to |= mask;
+                targets = plus == std::string_view::npos ? std::string_view() : targets.substr(plus + 1);
+            }
+        }
+        remaps[type].rebind(from, to);
+        return true;
+    }
+    return false;
+}
 
-    if (buttons & WPAD_CLASSIC_BUTTON_ZL)
-        convButtons |= VPAD_BUTTON_ZL;
+void InputUtils::loadButtonBindings(const std::string &path) {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) {
+        return;
+    }
 
-    if (buttons & WPAD_CLASSIC_BUTTON_R)
-        convButtons |= VPAD_BUTTON_R;
+    ButtonRemap remaps[LAYOUT_COUNT];
+    for (int32_t type = 0; type < LAYOUT_COUNT; type++) {
+        remaps[type] = *layouts[type].active.load(std::memory_order_acquire);
+    }
 
-    if (buttons & WPAD_CLASSIC_BUTTON_L)
-        convButtons |= VPAD_BUTTON_L;
+    uint32_t bindings = 0;
+    char buf[128]{};
+    while (fgets(buf, sizeof(buf), f)) {
+        auto line = TrimWhitespace(buf);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (!parseButtonBinding(line, remaps)) {
+            DEBUG_FUNCTION_LINE_WARN("Ignoring invalid button binding \"%.*s\"", (int) line.size(), line.data());
+            continue;
+        }
+        bindings++;
+    }
+    fclose(f);
 
-    return convButtons;
+    if (bindings == 0) {
+        return;
+    }
+    // The defaults stay untouched, the sampling callbacks switch over to the customized copies
+    for (int32_t type = 0; type < LAYOUT_COUNT; type++) {
+        layouts[type].custom = remaps[type];
+        layouts[type].active.store(&layouts[type].custom, std::memory_order_release);
+    }
+    DEBUG_FUNCTION_LINE_INFO("Loaded %d button bindings from %s", bindings, path.c_str());
 }
 
-InputUtils::InputData InputUtils::getControllerInput() {
-    InputData inputData     = {};
-    VPADStatus vpadStatus   = {};
-    VPADReadError vpadError = VPAD_READ_UNINITIALIZED;
-    int maxAttempts         = 100;
-    do {
-        if (VPADRead(VPAD_CHAN_0, &vpadStatus, 1, &vpadError) > 0 && vpadError == VPAD_READ_SUCCESS) {
-            inputData.trigger = vpadStatus.trigger;
-            inputData.hold    = vpadStatus.hold;
-            inputData.release = vpadStatus.release;
-        } else {
-            OSSleepTicks(OSMillisecondsToTicks(1));
-        }
-    } while (--maxAttempts > 0 && vpadError == VPAD_READ_NO_SAMPLES);
-
-    KPADStatus kpadStatus = {};
-    KPADError kpadError   = KPAD_ERROR_UNINITIALIZED;
-    for (int32_t i = 0; i < 4; i++) {
-        if (KPADReadEx((KPADChan) i, &kpadStatus, 1, &kpadError) > 0) {
-            if (kpadError == KPAD_ERROR_OK && kpadStatus.extensionType != 0xFF) {
-                if (kpadStatus.extensionType == WPAD_EXT_CORE || kpadStatus.extensionType == WPAD_EXT_NUNCHUK) {
-                    inputData.trigger |= remapWiiMoteButtons(kpadStatus.trigger);
-                    inputData.hold |= remapWiiMoteButtons(kpadStatus.hold);
-                    inputData.release |= remapWiiMoteButtons(kpadStatus.release);
-                } else {
-                    inputData.trigger |= remapClassicButtons(kpadStatus.classic.trigger);
-                    inputData.hold |= remapClassicButtons(kpadStatus.classic.hold);
-                    inputData.release |= remapClassicButtons(kpadStatus.classic.release);
-                }
-            }
+static bool hasFirstSamples() {
+    if (vpadSource.ring.getPushed() == 0) {
+        return false;
+    }
+    for (auto &source : kpadSources) {
+        if (source.connected.load(std::memory_order_relaxed) && source.ring.getPushed() == 0) {
+            return false;
         }
     }
-
-    return inputData;
+    return true;
 }
 
 void InputUtils::Init() {
     KPADInit();
     WPADEnableURCC(1);
+
+    VPADSetSamplingCallback(VPAD_CHAN_0, vpadSamplingCallback);
+    for (int32_t i = 0; i < KPAD_CHANNEL_COUNT; i++) {
+        // the connect callback keeps this up to date from here on
+        WPADExtensionType extensionType;
+        kpadSources[i].connected = WPADProbe((WPADChan) i, &extensionType) == 0;
+        KPADSetConnectCallback((KPADChan) i, kpadConnectCallback);
+        KPADSetSamplingCallback((KPADChan) i, kpadSamplingCallback);
+    }
+
+    // The boot button combos are checked right after this, wait once for the first sample of the GamePad and of
+    // every controller that is already connected.
+    for (int32_t i = 0; i < FIRST_SAMPLE_TIMEOUT_MS && !hasFirstSamples(); i++) {
+        OSSleepTicks(OSMillisecondsToTicks(1));
+    }
 }
 
 void InputUtils::DeInit() {
+    VPADSetSamplingCallback(VPAD_CHAN_0, nullptr);
+    for (int32_t i = 0; i < KPAD_CHANNEL_COUNT; i++) {
+        KPADSetSamplingCallback((KPADChan) i, nullptr);
+        KPADSetConnectCallback((KPADChan) i, nullptr);
+    }
     KPADShutdown();
-}
\ No newline at end of file
+
+    if (vpadSource.ring.getDropped() > 0) {
+        DEBUG_FUNCTION_LINE_WARN("Dropped %d GamePad samples", vpadSource.ring.getDropped());
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <string>
 #include <vpad/input.h>
 
 class InputUtils {
@@ -8,10 +9,18 @@ public:
         uint32_t trigger = 0;
         uint32_t hold    = 0;
         uint32_t release = 0;
+        // number of controller samples whose edges were merged into this
+        uint32_t samples = 0;
     } InputData;
 
     static void Init();
     static void DeInit();
 
     static InputData getControllerInput();
+
+    /**
+     * Overrides the default Wii Remote, Classic Controller and Pro Controller bindings with the ones from a config
+     * file, if it exists. Meant to be called once at boot.
+     */
+    static void loadButtonBindings(const std::string &path);
 };
@@ -0,0 +1,120 @@
+#include "LatencyMonitor.h"
+#include "logger.h"
+#include <cstdio>
+#include <cstring>
+
+// 1 ms per bucket, the last one also counts everything slower
+#define LATENCY_BUCKET_COUNT 100
+#define LATENCY_MAX_SCREENS  8
+#define LATENCY_CSV_PATH     "fs:/vol/external01/wiiu/autoboot_latency.csv"
+
+struct LatencyHistogram {
+    const char *screen;
+    uint32_t buckets[LATENCY_BUCKET_COUNT];
+    uint32_t count;
+    uint64_t totalUs;
+    uint32_t maxUs;
+};
+
+static LatencyHistogram histograms[LATENCY_MAX_SCREENS];
+static uint32_t histogramCount            = 0;
+static LatencyHistogram *currentHistogram = nullptr;
+static OSTime pendingInputTime            = 0;
+
+/**
+ * Upper bound in ms of the bucket that holds the given percentile of all presses.
+ */
+static uint32_t percentileMs(const LatencyHistogram &histogram, uint32_t percent) {
+    uint32_t target     = (histogram.count * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint32_t i = 0; i + 1 < LATENCY_BUCKET_COUNT; i++) {
+        cumulative += histogram.buckets[i];
+        if (cumulative >= target) {
+            return i + 1;
+        }
+    }
+    // the last bucket has no upper bound of its own
+    return histogram.maxUs / 1000 + 1;
+}
+
+void LatencyMonitor::setScreen(const char *name) {
+    pendingInputTime = 0;
+    currentHistogram = nullptr;
+    for (uint32_t i = 0; i < histogramCount; i++) {
+        if (strcmp(histograms[i].screen, name) == 0) {
+            currentHistogram = &histograms[i];
+            return;
+        }
+    }
+    if (histogramCount < LATENCY_MAX_SCREENS) {
+        currentHistogram         = &histograms[histogramCount++];
+        *currentHistogram        = {};
+        currentHistogram->screen = name;
+    }
+}
+
+void LatencyMonitor::inputConsumed(OSTime sampleTime) {
+    if (pendingInputTime == 0 || sampleTime < pendingInputTime) {
+        pendingInputTime = sampleTime;
+    }
+}
+
+void LatencyMonitor::frameFlipped(OSTime flipTime) {
+    if (pendingInputTime == 0) {
+        return;
+    }
+    auto latencyUs   = (uint32_t) OSTicksToMicroseconds(flipTime - pendingInputTime);
+    pendingInputTime = 0;
+    if (!currentHistogram) {
+        return;
+    }
+    uint32_t bucket = latencyUs / 1000;
+    if (bucket >= LATENCY_BUCKET_COUNT) {
+        bucket = LATENCY_BUCKET_COUNT - 1;
+    }
+    currentHistogram->buckets[bucket]++;
+    currentHistogram->count++;
+    currentHistogram->totalUs += latencyUs;
+    if (latencyUs > currentHistogram->maxUs) {
+        currentHistogram->maxUs = latencyUs;
+    }
+}
+
+#ifdef LATENCY_CSV
+static void writeCSV() {
+    FILE *f = fopen(LATENCY_CSV_PATH, "w");
+    if (!f) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to open %s", LATENCY_CSV_PATH);
+        return;
+    }
+    fputs("screen,from_ms,to_ms,presses\n", f);
+    for (uint32_t i = 0; i < histogramCount; i++) {
+        for (uint32_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+            if (bucket + 1 < LATENCY_BUCKET_COUNT) {
+                fprintf(f, "%s,%u,%u,%u\n", histograms[i].screen, (unsigned) bucket, (unsigned) bucket + 1, (unsigned) histograms[i].buckets[bucket]);
+            } else {
+                fprintf(f, "%s,%u,,%u\n", histograms[i].screen, (unsigned) bucket, (unsigned) histograms[i].buckets[bucket]);
+            }
+        }
+    }
+    fclose(f);
+}
+#endif
+
+void LatencyMonitor::report() {
+    for (uint32_t i = 0; i < histogramCount; i++) {
+        const LatencyHistogram &histogram = histograms[i];
+        if (histogram.count == 0) {
+            continue;
+        }
+        DEBUG_FUNCTION_LINE_INFO("Input latency of %s: %d presses, mean %lld us, p50 <%d ms, p90 <%d ms, p99 <%d ms, max %d us",
+                                 histogram.screen, histogram.count, histogram.totalUs / histogram.count,
+                                 percentileMs(histogram, 50), percentileMs(histogram, 90), percentileMs(histogram, 99), histogram.maxUs);
+    }
+#ifdef LATENCY_CSV
+    writeCSV();
+#endif
+    histogramCount   = 0;
+    currentHistogram = nullptr;
+    pendingInputTime = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <coreinit/time.h>
+#include <cstdint>
+
+/**
+ * Measures how long it takes from a button press until the first frame drawn after the press was read gets
+ * flipped, in one histogram per screen. All histograms live in fixed-size tables, measuring never allocates.
+ *
+ * Times are taken with OSGetSystemTime, like the timestamps of the input samples.
+ */
+class LatencyMonitor {
+public:
+    /**
+     * Attributes the following frames to a screen. The name has to stay valid, e.g. a string literal.
+     */
+    static void setScreen(const char *name);
+
+    /**
+     * Called with the sample time of the oldest button press a frame read.
+     */
+    static void inputConsumed(OSTime sampleTime);
+
+    /**
+     * Called right after the buffers were flipped. Records the latency of the presses read since the last flip.
+     */
+    static void frameFlipped(OSTime flipTime);
+
+    /**
+     * Logs a summary of every screen, writes the histograms as CSV when built with LATENCY_CSV=1 and starts over.
+     */
+    static void report();
+};
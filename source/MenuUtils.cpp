@@ -1,6 +1,8 @@
 #include "MenuUtils.h"
 #include "ACTAccountInfo.h"
+#include "DisplayList.h"
 #include "DrawUtils.h"
+#include "FrameScheduler.h"
 #include "InputUtils.h"
 #include "PairUtils.h"
 #include "logger.h"
@@ -9,10 +11,10 @@
 #include "version.h"
 #include <coreinit/debug.h>
 #include <coreinit/filesystem_fsa.h>
-#include <coreinit/screen.h>
 #include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <cstdio>
 #include <cstring>
-#include <gx2/state.h>
 #include <malloc.h>
 #include <memory>
 #include <mocha/mocha.h>
@@ -23,6 +25,9 @@
 
 #define AUTOBOOT_MODULE_VERSION "v0.3.2"
 
+// how long PLUS and MINUS need to be held to toggle the update blocking
+#define UPDATE_BLOCKED_HOLD_MS 850
+
 const char *autoboot_config_strings[] = {
         "wiiu_menu",
         "homebrew_launcher",
@@ -59,27 +64,17 @@ void writeAutobootOption(std::string &configPath, int32_t autobootOption) {
     }
 }
 
-void drawMenuScreen(const std::map<uint32_t, std::string> &menu, uint32_t selectedIndex, uint32_t autobootIndex, bool updatesBlocked) {
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BACKGROUND);
-
-    // draw buttons
-    uint32_t index = 8 + 24 + 8 + 4;
-    for (uint32_t i = 0; i < menu.size(); i++) {
-        if (i == (uint32_t) selectedIndex) {
-            DrawUtils::drawRect(16, index, SCREEN_WIDTH - 16 * 2, 44, 4, COLOR_BORDER_HIGHLIGHTED);
-        } else {
-            DrawUtils::drawRect(16, index, SCREEN_WIDTH - 16 * 2, 44, 2, (i == (uint32_t) autobootIndex) ? COLOR_AUTOBOOT : COLOR_BORDER);
-        }
-
-        std::string curName = std::next(menu.begin(), i)->second;
-
-        DrawUtils::setFontSize(24);
-        DrawUtils::setFontColor((i == (uint32_t) autobootIndex) ? COLOR_AUTOBOOT : COLOR_TEXT);
-        DrawUtils::print(16 * 2, index + 8 + 24, curName.c_str());
-        index += 42 + 8;
-    }
+/**
+ * Adds the glyphs of the pair screen, which can be opened from every screen, to the prewarm set of a screen.
+ */
+static std::vector<GlyphPrewarm> withPairScreenPrewarm(std::vector<GlyphPrewarm> prewarm) {
+    prewarm.push_back({"Press the SYNC Button on the Wii U GamePad, and enter the four symbols shown below.", 26});
+    prewarm.push_back({"\u2660\u2665\u2666\u2663", 100});
+    prewarm.push_back({"(0123456789 seconds remaining)", 20});
+    return prewarm;
+}
 
+void drawMenuScreenChrome() {
     DrawUtils::setFontColor(COLOR_TEXT);
 
     // draw top bar
@@ -87,40 +82,56 @@ void drawMenuScreen(const std::map<uint32_t, std::string> &menu, uint32_t select
     DrawUtils::print(16, 6 + 24, "Boot Selector");
     DrawUtils::drawRectFilled(8, 8 + 24 + 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
     DrawUtils::setFontSize(16);
-    DrawUtils::print(SCREEN_WIDTH - 16, 6 + 24, AUTOBOOT_MODULE_VERSION AUTOBOOT_MODULE_VERSION_EXTRA, true);
+    DrawUtils::print(SCREEN_WIDTH - 16, 6 + 24, AUTOBOOT_MODULE_VERSION AUTOBOOT_MODULE_VERSION_EXTRA, TEXT_ALIGN_RIGHT);
 
     // draw bottom bar
     DrawUtils::drawRectFilled(8, SCREEN_HEIGHT - 24 - 8 - 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
     DrawUtils::setFontSize(18);
     DrawUtils::print(16, SCREEN_HEIGHT - 8, "\ue07d Navigate ");
-    DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 8, "\ue000 Choose", true);
+    DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 8, "\ue000 Choose", TEXT_ALIGN_RIGHT);
     const char *autobootHints = "\ue002/\ue046 Clear Autoboot / \ue003/\ue045 Select Autoboot";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(autobootHints) / 2, SCREEN_HEIGHT - 8, autobootHints, true);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 8, autobootHints, TEXT_ALIGN_CENTER);
+}
+
+void drawMenuScreen(DisplayList &displayList, const std::map<uint32_t, std::string> &menu, uint32_t selectedIndex, uint32_t autobootIndex, bool updatesBlocked) {
+    displayList.beginFrame(COLOR_BACKGROUND);
+
+    // draw buttons
+    uint32_t index = 8 + 24 + 8 + 4;
+    for (uint32_t i = 0; i < menu.size(); i++) {
+        if (i == (uint32_t) selectedIndex) {
+            displayList.drawRect(16, index, SCREEN_WIDTH - 16 * 2, 44, 4, COLOR_BORDER_HIGHLIGHTED);
+        } else {
+            displayList.drawRect(16, index, SCREEN_WIDTH - 16 * 2, 44, 2, (i == (uint32_t) autobootIndex) ? COLOR_AUTOBOOT : COLOR_BORDER);
+        }
+
+        const std::string &curName = std::next(menu.begin(), i)->second;
+
+        displayList.print(16 * 2, index + 8 + 24, curName, 24, (i == (uint32_t) autobootIndex) ? COLOR_AUTOBOOT : COLOR_TEXT);
+        index += 42 + 8;
+    }
 
     if (updatesBlocked) {
-        DrawUtils::setFontSize(10);
-        DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 24 - 8 - 4 - 10, "Updates blocked! Hold \ue045 + \ue046 to restore Update folder", true);
+        displayList.print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 24 - 8 - 4 - 10, "Updates blocked! Hold \ue045 + \ue046 to restore Update folder", 10, COLOR_TEXT, TEXT_ALIGN_RIGHT);
     } else {
-        DrawUtils::setFontSize(10);
-        DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 24 - 8 - 4 - 10, "Updates not blocked! Hold \ue045 + \ue046 to delete Update folder", true);
+        displayList.print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 24 - 8 - 4 - 10, "Updates not blocked! Hold \ue045 + \ue046 to delete Update folder", 10, COLOR_TEXT, TEXT_ALIGN_RIGHT);
     }
 
-    DrawUtils::endDraw();
+    displayList.endFrame();
 }
 
-int32_t handleMenuScreen(std::string &configPath, int32_t autobootOptionInput, const std::map<uint32_t, std::string> &menu) {
-    auto screenBuffer = DrawUtils::InitOSScreen();
-    if (!screenBuffer) {
-        OSFatal("AutobootModule: Failed to alloc memory for screen");
-    }
-
-    uint32_t tvBufferSize  = OSScreenGetBufferSizeEx(SCREEN_TV);
-    uint32_t drcBufferSize = OSScreenGetBufferSizeEx(SCREEN_DRC);
-
-    DrawUtils::initBuffers(screenBuffer, tvBufferSize, (void *) ((uint32_t) screenBuffer + tvBufferSize), drcBufferSize);
-    if (!DrawUtils::initFont()) {
-        OSFatal("AutobootModule: Failed to init font");
+int32_t handleMenuScreen(UiSession &session, std::string &configPath, int32_t autobootOptionInput, const std::map<uint32_t, std::string> &menu) {
+    auto prewarm = withPairScreenPrewarm({
+            {"Boot Selector", 24},
+            {AUTOBOOT_MODULE_VERSION AUTOBOOT_MODULE_VERSION_EXTRA, 16},
+            {"\ue07d Navigate \ue000 Choose \ue002/\ue046 Clear Autoboot / \ue003/\ue045 Select Autoboot", 18},
+            {"Updates blocked! Hold \ue045 + \ue046 to restore Update folder", 10},
+            {"Updates not blocked! Hold \ue045 + \ue046 to delete Update folder", 10},
+    });
+    for (const auto &item : menu) {
+        prewarm.push_back({item.second, 24});
     }
+    session.beginScreen("Boot Selector", prewarm);
 
     int32_t selectedIndex = autobootOptionInput > 0 ? autobootOptionInput : 0;
     int autobootIndex     = autobootOptionInput;
@@ -146,16 +157,23 @@ int32_t handleMenuScreen(std::string &configPath, int32_t autobootOptionInput, c
     }
 
     {
-        PairMenu pairMenu;
+        DisplayList displayList;
+        FrameScheduler scheduler;
+        PairMenu pairMenu(scheduler);
+        displayList.setStaticContent(drawMenuScreenChrome);
 
-        int32_t holdUpdateBlockedForFrames = 0;
+        OSTime holdUpdateBlockedSince = 0;
         while (true) {
+            scheduler.waitForNextFrame();
             if (pairMenu.ProcessPairScreen()) {
+                // the pair screen draws over us, it requests a redraw once it's done.
                 continue;
             }
 
-
             InputUtils::InputData input = InputUtils::getControllerInput();
+            if (input.trigger | input.release) {
+                scheduler.requestRedraw();
+            }
 
             if (input.trigger & VPAD_BUTTON_UP) {
                 selectedIndex--;
@@ -179,32 +197,29 @@ int32_t handleMenuScreen(std::string &configPath, int32_t autobootOptionInput, c
             } else if (input.trigger & (VPAD_BUTTON_Y | VPAD_BUTTON_PLUS)) {
                 autobootIndex = selectedIndex;
             } else if ((input.hold & (VPAD_BUTTON_PLUS | VPAD_BUTTON_MINUS)) == (VPAD_BUTTON_PLUS | VPAD_BUTTON_MINUS)) {
-                if (holdUpdateBlockedForFrames++ > 50) {
+                OSTime now = OSGetTime();
+                if (holdUpdateBlockedSince == 0) {
+                    holdUpdateBlockedSince = now;
+                } else if (now - holdUpdateBlockedSince > OSMillisecondsToTicks(UPDATE_BLOCKED_HOLD_MS)) {
                     if (gUpdatesBlocked) {
                         gUpdatesBlocked = !RestoreMLCUpdateDirectory();
                     } else {
                         gUpdatesBlocked = DeleteMLCUpdateDirectory();
                     }
-                    holdUpdateBlockedForFrames = 0;
+                    holdUpdateBlockedSince = 0;
+                    scheduler.requestRedraw();
                 }
             } else {
-                holdUpdateBlockedForFrames = 0;
+                holdUpdateBlockedSince = 0;
             }
 
-            drawMenuScreen(menu, selectedIndex, autobootIndex, gUpdatesBlocked);
+            if (scheduler.shouldRender()) {
+                drawMenuScreen(displayList, menu, selectedIndex, autobootIndex, gUpdatesBlocked);
+            }
         }
     }
 
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BLACK);
-    DrawUtils::endDraw();
-
-    DrawUtils::deinitFont();
-
-    // Call GX2Init to shut down OSScreen
-    GX2Init(nullptr);
-
-    free(screenBuffer);
+    session.endScreen();
 
     int32_t selected = -1;
     int32_t autoboot = -1;
@@ -223,29 +238,85 @@ int32_t handleMenuScreen(std::string &configPath, int32_t autobootOptionInput, c
     return selected;
 }
 
-nn::act::SlotNo handleAccountSelectScreen(const std::vector<std::shared_ptr<AccountInfo>> &data) {
-    auto screenBuffer = DrawUtils::InitOSScreen();
-    if (!screenBuffer) {
-        OSFatal("AutobootModule: Failed to alloc memory for screen");
-    }
+void drawAccountSelectScreenChrome() {
+    DrawUtils::setFontColor(COLOR_TEXT);
 
-    uint32_t tvBufferSize  = OSScreenGetBufferSizeEx(SCREEN_TV);
-    uint32_t drcBufferSize = OSScreenGetBufferSizeEx(SCREEN_DRC);
+    // draw top bar
+    DrawUtils::setFontSize(24);
+    DrawUtils::print(16, 6 + 24, "Select your Account");
+    DrawUtils::drawRectFilled(8, 8 + 24 + 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
 
-    DrawUtils::initBuffers(screenBuffer, tvBufferSize, (void *) ((uint32_t) screenBuffer + tvBufferSize), drcBufferSize);
-    if (!DrawUtils::initFont()) {
-        OSFatal("AutobootModule: Failed to init font");
+    // draw bottom bar
+    DrawUtils::drawRectFilled(8, SCREEN_HEIGHT - 24 - 8 - 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
+    DrawUtils::setFontSize(18);
+    DrawUtils::print(16, SCREEN_HEIGHT - 8, "\ue07d Navigate ");
+    DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 8, "\ue000 Choose", TEXT_ALIGN_RIGHT);
+}
+
+/**
+ * Scales the 128x128 Mii image of an account down to 64x64 and replaces its background with the screen color.
+ */
+static bool decodeMiiImage(const AccountInfo &account, DecodedImage &image) {
+    constexpr uint32_t width         = 128;
+    constexpr uint32_t height        = 128;
+    constexpr uint32_t target_width  = 64;
+    constexpr uint32_t target_height = 64;
+
+    std::vector<uint32_t> pixels(target_width * target_height);
+    const uint8_t *buf = account.miiImageBuffer;
+    for (uint32_t y = 0; y < target_height; y++) {
+        for (uint32_t x = 0; x < target_width; x++) {
+            // the image is ARGB and upside down
+            uint32_t col    = ((x * width / target_width) + ((target_height - y - 1) * height / target_height) * width) * 4;
+            uint32_t colVal = (buf[col + 1] << 24) | (buf[col + 2] << 16) | (buf[col + 3] << 8) | buf[col + 4];
+            if (colVal == 0x00808080) { // Remove the green background.
+                pixels[y * target_width + x] = COLOR_BACKGROUND.color;
+            } else {
+                pixels[y * target_width + x] = Color(buf[col + 1], buf[col + 2], buf[col + 3], buf[col]).color;
+            }
+        }
     }
+    return image.loadPixels(pixels.data(), target_width, target_height);
+}
+
+nn::act::SlotNo handleAccountSelectScreen(UiSession &session, const std::vector<std::shared_ptr<AccountInfo>> &data) {
+    auto prewarm = withPairScreenPrewarm({
+            {"Select your Account ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_-.():/", 24},
+            {"\uE01B\uE01C", 36},
+            {"\ue07d Navigate \ue000 Choose", 18},
+    });
+    session.beginScreen("Account Selection", prewarm);
 
     int32_t selected = 0;
     {
-        PairMenu pairMenu;
+        // converted once, the display list only keeps pointers to them
+        std::vector<DecodedImage> miiImages(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i]->miiImageSize > 0 && !decodeMiiImage(*data[i], miiImages[i])) {
+                DEBUG_FUNCTION_LINE_WARN("Failed to convert the Mii image of slot %d", data[i]->slot);
+            }
+        }
+        std::vector<std::string> labels;
+        labels.reserve(data.size());
+        for (auto const &val : data) {
+            labels.push_back(val->name + (val->isNetworkAccount ? (std::string(" (NNID: ") + val->accountId + ")") : ""));
+        }
+
+        DisplayList displayList;
+        FrameScheduler scheduler;
+        PairMenu pairMenu(scheduler);
+        displayList.setStaticContent(drawAccountSelectScreenChrome);
         while (true) {
+            scheduler.waitForNextFrame();
             if (pairMenu.ProcessPairScreen()) {
+                // the pair screen draws over us, it requests a redraw once it's done.
                 continue;
             }
 
             InputUtils::InputData input = InputUtils::getControllerInput();
+            if (input.trigger | input.release) {
+                scheduler.requestRedraw();
+            }
             if (input.trigger & VPAD_BUTTON_UP) {
                 if (selected > 0) {
                     selected--;
@@ -258,90 +329,50 @@ nn::act::SlotNo handleAccountSelectScreen(const std::vector<std::shared_ptr<Acco
                 break;
             }
 
+            if (!scheduler.shouldRender()) {
+                continue;
+            }
 
-            DrawUtils::beginDraw();
-            DrawUtils::clear(COLOR_BACKGROUND);
+            displayList.beginFrame(COLOR_BACKGROUND);
 
             // draw buttons
             uint32_t index = 8 + 24 + 8 + 4;
             int32_t start  = (selected / 5) * 5;
             int32_t end    = (start + 5) < (int32_t) data.size() ? (start + 5) : data.size();
             for (int i = start; i < end; i++) {
-                auto &val = data[i];
-                if (val->miiImageSize > 0) {
-                    // Draw Mii
-                    auto width         = 128;
-                    auto height        = 128;
-                    auto target_height = 64u;
-                    auto target_width  = 64u;
-                    auto xOffset       = 20;
-                    auto yOffset       = index;
-                    for (uint32_t y = 0; y < target_height; y++) {
-                        for (uint32_t x = 0; x < target_width; x++) {
-                            uint32_t col    = (((x) *width / target_width) + ((target_height - y - 1) * height / target_height) * width) * 4;
-                            uint32_t colVal = ((uint32_t *) &val->miiImageBuffer[col + 1])[0];
-                            if (colVal == 0x00808080) { // Remove the green background.
-                                DrawUtils::drawPixel(x + xOffset, y + yOffset, COLOR_BACKGROUND.r, COLOR_BACKGROUND.g, COLOR_BACKGROUND.b, COLOR_BACKGROUND.a);
-                            } else {
-                                DrawUtils::drawPixel(x + xOffset, y + yOffset, val->miiImageBuffer[col + 1], val->miiImageBuffer[col + 2], val->miiImageBuffer[col + 3], val->miiImageBuffer[col]);
-                            }
-                        }
-                    }
+                if (miiImages[i].isValid()) {
+                    displayList.drawImage(20, index, miiImages[i]);
                 }
 
                 if (i == selected) {
-                    DrawUtils::drawRect(16, index, SCREEN_WIDTH - 16 * 2, 64, 4, COLOR_BORDER_HIGHLIGHTED);
+                    displayList.drawRect(16, index, SCREEN_WIDTH - 16 * 2, 64, 4, COLOR_BORDER_HIGHLIGHTED);
                 }
 
-                DrawUtils::setFontSize(24);
-                DrawUtils::setFontColor(COLOR_TEXT);
-
-                std::string finalStr = val->name + (val->isNetworkAccount ? (std::string(" (NNID: ") + val->accountId + ")") : "");
-                DrawUtils::print(72 + 16 * 2, index + 8 + 32, finalStr.c_str());
+                displayList.print(72 + 16 * 2, index + 8 + 32, labels[i], 24, COLOR_TEXT);
 
                 index += 72 + 8;
             }
 
-            DrawUtils::setFontColor(COLOR_TEXT);
-
-            // draw top bar
-            DrawUtils::setFontSize(24);
-            DrawUtils::print(16, 6 + 24, "Select your Account");
+            // draw page number
             auto curPage    = (selected / 5) + 1;
             auto totalPages = data.size() % 5 == 0 ? data.size() / 5 : data.size() / 5 + 1;
-            DrawUtils::print(SCREEN_WIDTH - 50, 6 + 24, string_format("%d/%d", curPage, totalPages).c_str());
-            DrawUtils::drawRectFilled(8, 8 + 24 + 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
-
-            // draw bottom bar
-            DrawUtils::drawRectFilled(8, SCREEN_HEIGHT - 24 - 8 - 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
-            DrawUtils::setFontSize(18);
-            DrawUtils::print(16, SCREEN_HEIGHT - 8, "\ue07d Navigate ");
-            DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 8, "\ue000 Choose", true);
+            char pageStr[16];
+            snprintf(pageStr, sizeof(pageStr), "%d/%d", (int) curPage, (int) totalPages);
+            displayList.print(SCREEN_WIDTH - 50, 6 + 24, pageStr, 24, COLOR_TEXT);
 
             if (start > 0) {
-                DrawUtils::setFontSize(36);
-                DrawUtils::print(SCREEN_WIDTH - 30, 68, "\uE01B", true);
+                displayList.print(SCREEN_WIDTH - 30, 68, "\uE01B", 36, COLOR_TEXT, TEXT_ALIGN_RIGHT);
             }
 
             if (end < (int32_t) data.size()) {
-                DrawUtils::setFontSize(36);
-                DrawUtils::print(SCREEN_WIDTH - 30, SCREEN_HEIGHT - 40, "\uE01C", true);
+                displayList.print(SCREEN_WIDTH - 30, SCREEN_HEIGHT - 40, "\uE01C", 36, COLOR_TEXT, TEXT_ALIGN_RIGHT);
             }
 
-            DrawUtils::endDraw();
+            displayList.endFrame();
         }
     }
 
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BLACK);
-    DrawUtils::endDraw();
-
-    DrawUtils::deinitFont();
-
-    // Call GX2Init to shut down OSScreen
-    GX2Init(nullptr);
-
-    free(screenBuffer);
+    session.endScreen();
 
     auto i                     = 0;
     nn::act::SlotNo resultSlot = 0;
@@ -355,46 +386,39 @@ nn::act::SlotNo handleAccountSelectScreen(const std::vector<std::shared_ptr<Acco
     return resultSlot;
 }
 
-void drawUpdateWarningScreen() {
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BACKGROUND_WARN);
-
+void drawUpdateWarningChrome() {
     DrawUtils::setFontColor(COLOR_WARNING);
 
     // draw top bar
-    DrawUtils::setFontSize(48);
     const char *title = "! Warning !";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(title) / 2, 48 + 8, title, true);
+    DrawUtils::setFontSize(48);
+    DrawUtils::print(SCREEN_WIDTH / 2, 48 + 8, title, TEXT_ALIGN_CENTER);
     DrawUtils::drawRectFilled(8, 48 + 8 + 16, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
 
-    DrawUtils::setFontSize(24);
-
     const char *message = "The update folder currently exists and is not a file.";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(message) / 2, SCREEN_HEIGHT / 2 - 48, message, true);
+    DrawUtils::setFontSize(24);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 48, message, TEXT_ALIGN_CENTER);
     message = "Your system might not be blocking updates properly!";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(message) / 2, SCREEN_HEIGHT / 2 - 24, message, true);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 24, message, TEXT_ALIGN_CENTER);
 
     message = "Press \ue002 to block the updates! This can be reverted in the Boot Selector.";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(message) / 2, SCREEN_HEIGHT / 2 + 24, message, true);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 24, message, TEXT_ALIGN_CENTER);
 
     message = "See https://wiiu.hacks.guide/#/block-updates for more information.";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(message) / 2, SCREEN_HEIGHT / 2 + 64 + 24, message, true);
-
-    DrawUtils::setFontSize(16);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 64 + 24, message, TEXT_ALIGN_CENTER);
 
     message = "Press the SYNC Button on the Wii U console to connect a controller or GamePad.";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(message) / 2, SCREEN_HEIGHT - 48, message, true);
+    DrawUtils::setFontSize(16);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 48, message, TEXT_ALIGN_CENTER);
 
     // draw bottom bar
     DrawUtils::drawRectFilled(8, SCREEN_HEIGHT - 24 - 8 - 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
-    DrawUtils::setFontSize(18);
     const char *exitHints = "\ue000 Continue without blocking / \ue001 Don't show this again";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(exitHints) / 2, SCREEN_HEIGHT - 8, exitHints, true);
-
-    DrawUtils::endDraw();
+    DrawUtils::setFontSize(18);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 8, exitHints, TEXT_ALIGN_CENTER);
 }
 
-void handleUpdateWarningScreen() {
+void handleUpdateWarningScreen(UiSession &session) {
     FILE *f = fopen(UPDATE_SKIP_PATH, "r");
     if (f) {
         DEBUG_FUNCTION_LINE("Skipping update warning screen");
@@ -402,28 +426,35 @@ void handleUpdateWarningScreen() {
         return;
     }
 
-    auto screenBuffer = DrawUtils::InitOSScreen();
-    if (!screenBuffer) {
-        OSFatal("AutobootModule: Failed to alloc memory for screen");
-    }
-
-    uint32_t tvBufferSize  = OSScreenGetBufferSizeEx(SCREEN_TV);
-    uint32_t drcBufferSize = OSScreenGetBufferSizeEx(SCREEN_DRC);
-
-    DrawUtils::initBuffers(screenBuffer, tvBufferSize, (void *) ((uint32_t) screenBuffer + tvBufferSize), drcBufferSize);
-    if (!DrawUtils::initFont()) {
-        OSFatal("AutobootModule: Failed to init font");
-    }
+    auto prewarm = withPairScreenPrewarm({
+            {"! Warning !", 48},
+            {"The update folder currently exists and is not a file. Your system might not be blocking updates properly! "
+             "Press \ue002 to block the updates! This can be reverted in the Boot Selector. "
+             "See https://wiiu.hacks.guide/#/block-updates for more information.",
+             24},
+            {"Press the SYNC Button on the Wii U console to connect a controller or GamePad.", 16},
+            {"\ue000 Continue without blocking / \ue001 Don't show this again", 18},
+    });
+    session.beginScreen("Update Warning", prewarm);
 
     {
-        PairMenu pairMenu;
+        DisplayList displayList;
+        FrameScheduler scheduler;
+        PairMenu pairMenu(scheduler);
+        // the whole screen is static, after the first frame it's only restored from the layer
+        displayList.setStaticContent(drawUpdateWarningChrome);
 
         while (true) {
+            scheduler.waitForNextFrame();
             if (pairMenu.ProcessPairScreen()) {
+                // the pair screen draws over us, it requests a redraw once it's done.
                 continue;
             }
 
-            drawUpdateWarningScreen();
+            if (scheduler.shouldRender()) {
+                displayList.beginFrame(COLOR_BACKGROUND_WARN);
+                displayList.endFrame();
+            }
 
             InputUtils::InputData input = InputUtils::getControllerInput();
             if (input.trigger & VPAD_BUTTON_A) {
@@ -446,44 +477,36 @@ void handleUpdateWarningScreen() {
         }
     }
 
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BLACK);
-    DrawUtils::endDraw();
-
-    DrawUtils::deinitFont();
-
-    GX2Init(nullptr);
-
-    free(screenBuffer);
+    session.endScreen();
 }
 
-void drawDiscInsert(bool wrongDiscInserted) {
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BACKGROUND);
+void drawDiscInsertChrome() {
     DrawUtils::setFontColor(COLOR_TEXT);
 
-    DrawUtils::setFontSize(48);
+    const char *exitHints = "\ue000 Launch Wii U Menu";
+    DrawUtils::setFontSize(18);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 8, exitHints, TEXT_ALIGN_CENTER);
+}
+
+void drawDiscInsert(DisplayList &displayList, bool wrongDiscInserted) {
+    displayList.beginFrame(COLOR_BACKGROUND);
 
     if (wrongDiscInserted) {
         const char *title = "The disc inserted into the console";
-        DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(title) / 2, 40 + 48 + 8, title, true);
+        displayList.print(SCREEN_WIDTH / 2, 40 + 48 + 8, title, 48, COLOR_TEXT, TEXT_ALIGN_CENTER);
         title = "is for a different software title.";
-        DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(title) / 2, 40 + 2 * 48 + 8, title, true);
+        displayList.print(SCREEN_WIDTH / 2, 40 + 2 * 48 + 8, title, 48, COLOR_TEXT, TEXT_ALIGN_CENTER);
         title = "Please change the disc.";
-        DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(title) / 2, 40 + 4 * 48 + 8, title, true);
+        displayList.print(SCREEN_WIDTH / 2, 40 + 4 * 48 + 8, title, 48, COLOR_TEXT, TEXT_ALIGN_CENTER);
     } else {
         const char *title = "Please insert a disc.";
-        DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(title) / 2, 40 + 48 + 8, title, true);
+        displayList.print(SCREEN_WIDTH / 2, 40 + 48 + 8, title, 48, COLOR_TEXT, TEXT_ALIGN_CENTER);
     }
 
-    DrawUtils::setFontSize(18);
-    const char *exitHints = "\ue000 Launch Wii U Menu";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(exitHints) / 2, SCREEN_HEIGHT - 8, exitHints, true);
-
-    DrawUtils::endDraw();
+    displayList.endFrame();
 }
 
-bool handleDiscInsertScreen(uint64_t expectedTitleId, uint64_t *titleIdToLaunch) {
+bool handleDiscInsertScreen(UiSession &session, uint64_t expectedTitleId, uint64_t *titleIdToLaunch) {
     if (titleIdToLaunch == nullptr) {
         DEBUG_FUNCTION_LINE_ERR("titleIdToLaunch is NULL");
         return false;
@@ -517,18 +540,11 @@ bool handleDiscInsertScreen(uint64_t expectedTitleId, uint64_t *titleIdToLaunch)
     }
 
     bool result;
-    auto screenBuffer = DrawUtils::InitOSScreen();
-    if (!screenBuffer) {
-        OSFatal("AutobootModule: Failed to alloc memory for screen");
-    }
-
-    uint32_t tvBufferSize  = OSScreenGetBufferSizeEx(SCREEN_TV);
-    uint32_t drcBufferSize = OSScreenGetBufferSizeEx(SCREEN_DRC);
-
-    DrawUtils::initBuffers(screenBuffer, tvBufferSize, (void *) ((uint32_t) screenBuffer + tvBufferSize), drcBufferSize);
-    if (!DrawUtils::initFont()) {
-        OSFatal("AutobootModule: Failed to init font");
-    }
+    auto prewarm = withPairScreenPrewarm({
+            {"The disc inserted into the console is for a different software title. Please change the disc. Please insert a disc.", 48},
+            {"\ue000 Launch Wii U Menu", 18},
+    });
+    session.beginScreen("Disc Insert", prewarm);
     DrawUtils::beginDraw();
     DrawUtils::clear(COLOR_BACKGROUND);
     DrawUtils::endDraw();
@@ -536,14 +552,21 @@ bool handleDiscInsertScreen(uint64_t expectedTitleId, uint64_t *titleIdToLaunch)
     // When an unexpected disc was inserted we need to eject it first.
     bool allowDisc = !wrongDiscInserted;
     {
-        PairMenu pairMenu;
+        DisplayList displayList;
+        FrameScheduler scheduler;
+        PairMenu pairMenu(scheduler);
+        displayList.setStaticContent(drawDiscInsertChrome);
 
         while (true) {
+            scheduler.waitForNextFrame();
             if (pairMenu.ProcessPairScreen()) {
+                // the pair screen draws over us, it requests a redraw once it's done.
                 continue;
             }
 
-            drawDiscInsert(wrongDiscInserted);
+            if (scheduler.shouldRender()) {
+                drawDiscInsert(displayList, wrongDiscInserted);
+            }
 
             InputUtils::InputData input = InputUtils::getControllerInput();
             if (input.trigger & VPAD_BUTTON_A) {
@@ -568,16 +591,7 @@ bool handleDiscInsertScreen(uint64_t expectedTitleId, uint64_t *titleIdToLaunch)
         }
     }
 
-    DrawUtils::beginDraw();
-    DrawUtils::clear(COLOR_BLACK);
-    DrawUtils::endDraw();
-
-    DrawUtils::deinitFont();
-
-    // Call GX2Init to shut down OSScreen
-    GX2Init(nullptr);
-
-    free(screenBuffer);
+    session.endScreen();
 
     return result;
 }
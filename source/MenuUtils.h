@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ACTAccountInfo.h"
+#include "UiSession.h"
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -32,10 +33,10 @@ int32_t readAutobootOption(std::string &configPath);
 
 void writeAutobootOption(std::string &configPath, int32_t autobootOption);
 
-int32_t handleMenuScreen(std::string &configPath, int32_t autobootOptionInput, const std::map<uint32_t, std::string> &menu);
+int32_t handleMenuScreen(UiSession &session, std::string &configPath, int32_t autobootOptionInput, const std::map<uint32_t, std::string> &menu);
 
-nn::act::SlotNo handleAccountSelectScreen(const std::vector<std::shared_ptr<AccountInfo>> &data);
+nn::act::SlotNo handleAccountSelectScreen(UiSession &session, const std::vector<std::shared_ptr<AccountInfo>> &data);
 
-void handleUpdateWarningScreen();
+void handleUpdateWarningScreen(UiSession &session);
 
-bool handleDiscInsertScreen(uint64_t expectedTitleId, uint64_t *titleIdToLaunch);
+bool handleDiscInsertScreen(UiSession &session, uint64_t expectedTitleId, uint64_t *titleIdToLaunch);
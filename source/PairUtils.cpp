@@ -5,60 +5,56 @@
 #include "utils.h"
 #include <coreinit/cache.h>
 #include <coreinit/thread.h>
+#include <cstdio>
 #include <malloc.h>
 #include <nn/ccr/sys.h>
 #include <padscore/kpad.h>
 #include <padscore/wpad.h>
 #include <vpad/input.h>
 
-void PairMenu::drawPairKPADScreen() const {
+void PairMenu::drawPairKPADScreen() {
     DrawUtils::beginDraw();
     DrawUtils::clear(COLOR_BACKGROUND);
 
     DrawUtils::setFontColor(COLOR_TEXT);
 
-    DrawUtils::setFontSize(26);
-
-    std::string textLine1 = "Press the SYNC Button on the controller you want to pair.";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(textLine1.c_str()) / 2, 40, textLine1.c_str(), true);
+    mKPADTitleRun.set("Press the SYNC Button on the controller you want to pair.", 26);
+    DrawUtils::print(SCREEN_WIDTH / 2, 40, mKPADTitleRun, TEXT_ALIGN_CENTER);
 
 
     WPADExtensionType ext{};
     for (int i = 0; i < 4; i++) {
-        bool isConnected     = WPADProbe((WPADChan) i, &ext) == 0;
-        std::string textLine = string_format("Slot %d: ", i + 1);
+        bool isConnected   = WPADProbe((WPADChan) i, &ext) == 0;
+        const char *status = "No controller";
         if (isConnected) {
-            textLine += ext == WPAD_EXT_PRO_CONTROLLER ? "Pro Controller" : "Wiimote";
-        } else {
-            textLine += "No controller";
+            status = ext == WPAD_EXT_PRO_CONTROLLER ? "Pro Controller" : "Wiimote";
         }
+        char textLine[32];
+        snprintf(textLine, sizeof(textLine), "Slot %d: %s", i + 1, status);
 
-        DrawUtils::print(300, 140 + (i * 30), textLine.c_str());
+        mSlotRuns[i].set(textLine, 26);
+        DrawUtils::print(300, 140 + (i * 30), mSlotRuns[i]);
     }
 
-    DrawUtils::setFontSize(26);
-
-    std::string gamepadSyncText1 = "If you are pairing a Wii U GamePad, press the SYNC Button";
-    std::string gamepadSyncText2 = "on your Wii U console one more time";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(gamepadSyncText1.c_str()) / 2, SCREEN_HEIGHT - 100, gamepadSyncText1.c_str(), true);
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(gamepadSyncText2.c_str()) / 2, SCREEN_HEIGHT - 70, gamepadSyncText2.c_str(), true);
+    mGamePadSyncHintRuns[0].set("If you are pairing a Wii U GamePad, press the SYNC Button", 26);
+    mGamePadSyncHintRuns[1].set("on your Wii U console one more time", 26);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 100, mGamePadSyncHintRuns[0], TEXT_ALIGN_CENTER);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 70, mGamePadSyncHintRuns[1], TEXT_ALIGN_CENTER);
 
-    DrawUtils::setFontSize(16);
-
-    const char *exitHints = "Press \ue001 to return";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(exitHints) / 2, SCREEN_HEIGHT - 8, exitHints, true);
+    mKPADExitHintRun.set("Press \ue001 to return", 16);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 8, mKPADExitHintRun, TEXT_ALIGN_CENTER);
 
     DrawUtils::endDraw();
 }
 
-void PairMenu::drawPairScreen() const {
+void PairMenu::drawPairScreen() {
     DrawUtils::beginDraw();
     DrawUtils::clear(COLOR_BACKGROUND);
 
     DrawUtils::setFontColor(COLOR_TEXT);
 
     // Convert the pin to symbols and set the text
-    static char pinSymbols[][4] = {
+    static const char pinSymbols[][4] = {
             "\u2660",
             "\u2665",
             "\u2666",
@@ -66,36 +62,33 @@ void PairMenu::drawPairScreen() const {
 
     uint32_t pincode = mGamePadPincode;
 
-    std::string pin = std::string(pinSymbols[(pincode / 1000) % 10]) +
-                      pinSymbols[(pincode / 100) % 10] +
-                      pinSymbols[(pincode / 10) % 10] +
-                      pinSymbols[pincode % 10];
-
-    std::string textLine1 = "Press the SYNC Button on the Wii U GamePad,";
-    std::string textLine2 = "and enter the four symbols shown below.";
+    char pin[16];
+    snprintf(pin, sizeof(pin), "%s%s%s%s",
+             pinSymbols[(pincode / 1000) % 10],
+             pinSymbols[(pincode / 100) % 10],
+             pinSymbols[(pincode / 10) % 10],
+             pinSymbols[pincode % 10]);
 
-    DrawUtils::setFontSize(26);
+    mGamePadTitleRuns[0].set("Press the SYNC Button on the Wii U GamePad,", 26);
+    mGamePadTitleRuns[1].set("and enter the four symbols shown below.", 26);
+    DrawUtils::print(SCREEN_WIDTH / 2, 60, mGamePadTitleRuns[0], TEXT_ALIGN_CENTER);
+    DrawUtils::print(SCREEN_WIDTH / 2, 100, mGamePadTitleRuns[1], TEXT_ALIGN_CENTER);
 
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(textLine1.c_str()) / 2, 60, textLine1.c_str(), true);
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(textLine2.c_str()) / 2, 100, textLine2.c_str(), true);
+    mPinRun.set(pin, 100);
+    DrawUtils::print(SCREEN_WIDTH / 2, (SCREEN_HEIGHT / 2) + 40, mPinRun, TEXT_ALIGN_CENTER);
 
-    DrawUtils::setFontSize(100);
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(pin.c_str()) / 2, (SCREEN_HEIGHT / 2) + 40, pin.c_str(), true);
+    char textLine3[48];
+    snprintf(textLine3, sizeof(textLine3), "(%d seconds remaining) ", mGamePadSyncTimeout - (uint32_t) (OSTicksToSeconds(OSGetTime() - mSyncGamePadStartTime)));
+    mCountdownRun.set(textLine3, 20);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 80, mCountdownRun, TEXT_ALIGN_CENTER);
 
-    DrawUtils::setFontSize(20);
-
-    std::string textLine3 = string_format("(%d seconds remaining) ", mGamePadSyncTimeout - (uint32_t) (OSTicksToSeconds(OSGetTime() - mSyncGamePadStartTime)));
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(textLine3.c_str()) / 2, SCREEN_HEIGHT - 80, textLine3.c_str(), true);
-
-    DrawUtils::setFontSize(26);
-
-    std::string textLine4 = "Press the SYNC Button on the Wii U console to exit.";
-    DrawUtils::print(SCREEN_WIDTH / 2 + DrawUtils::getTextWidth(textLine4.c_str()) / 2, SCREEN_HEIGHT - 40, textLine4.c_str(), true);
+    mGamePadExitHintRun.set("Press the SYNC Button on the Wii U console to exit.", 26);
+    DrawUtils::print(SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40, mGamePadExitHintRun, TEXT_ALIGN_CENTER);
 
     DrawUtils::endDraw();
 }
 
-PairMenu::PairMenu() {
+PairMenu::PairMenu(FrameScheduler &scheduler) : mScheduler(scheduler) {
     CCRSysInit();
 
     mState              = STATE_WAIT;
@@ -202,17 +195,43 @@ bool PairMenu::ProcessPairScreen() {
         case STATE_WAIT:
             break;
     }
+    if (mState != mDrawnState) {
+        mDrawnState = mState;
+        mScheduler.requestRedraw();
+    }
     switch (mState) {
         case STATE_WAIT: {
             return false;
         }
-        case STATE_SYNC_WPAD:
-            drawPairKPADScreen();
+        case STATE_SYNC_WPAD: {
+            // the slot list needs a redraw whenever a controller connects or disconnects
+            uint32_t slotStatus = 0;
+            WPADExtensionType ext{};
+            for (int i = 0; i < 4; i++) {
+                if (WPADProbe((WPADChan) i, &ext) == 0) {
+                    slotStatus |= (ext == WPAD_EXT_PRO_CONTROLLER ? 2 : 1) << (i * 2);
+                }
+            }
+            if (slotStatus != mDrawnSlotStatus) {
+                mDrawnSlotStatus = slotStatus;
+                mScheduler.requestRedraw();
+            }
+            if (mScheduler.shouldRender()) {
+                drawPairKPADScreen();
+            }
             break;
+        }
         case STATE_SYNC_GAMEPAD:
         case STATE_PAIRING:
         case STATE_CANCEL: {
-            drawPairScreen();
+            if (mState == STATE_PAIRING) {
+                // update the countdown once per second
+                auto elapsedSeconds = OSTicksToSeconds(OSGetTime() - mSyncGamePadStartTime);
+                mScheduler.requestRedrawAt(mSyncGamePadStartTime + OSSecondsToTicks(elapsedSeconds + 1));
+            }
+            if (mScheduler.shouldRender()) {
+                drawPairScreen();
+            }
             break;
         }
     }
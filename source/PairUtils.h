@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DrawUtils.h"
+#include "FrameScheduler.h"
 #include "MenuUtils.h"
 #include "logger.h"
 #include <coreinit/cache.h>
@@ -12,7 +14,11 @@
 
 class PairMenu {
 public:
-    PairMenu();
+    /**
+     * The pair screens are paced by and redraw through the scheduler of the screen they're shown on. When they're
+     * closed a redraw of that screen is requested.
+     */
+    explicit PairMenu(FrameScheduler &scheduler);
 
     ~PairMenu();
 
@@ -20,9 +26,9 @@ public:
 
     static void SyncButtonCallback(IOSError error, void *arg);
 
-    void drawPairScreen() const;
+    void drawPairScreen();
 
-    void drawPairKPADScreen() const;
+    void drawPairKPADScreen();
 
 private:
     enum PairMenuState {
@@ -42,4 +48,18 @@ private:
     PairMenuState mState         = STATE_WAIT;
     uint32_t mGamePadSyncTimeout = 120;
     IMEventMask mIMEventMask{};
+
+    FrameScheduler &mScheduler;
+    PairMenuState mDrawnState = STATE_WAIT;
+    uint32_t mDrawnSlotStatus = 0;
+
+    // text of both screens, a run is only laid out again when its text changes
+    TextRun mKPADTitleRun;
+    TextRun mSlotRuns[4];
+    TextRun mGamePadSyncHintRuns[2];
+    TextRun mKPADExitHintRun;
+    TextRun mGamePadTitleRuns[2];
+    TextRun mPinRun;
+    TextRun mCountdownRun;
+    TextRun mGamePadExitHintRun;
 };
\ No newline at end of file
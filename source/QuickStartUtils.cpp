@@ -177,7 +177,7 @@ private:
     int disconnectedCount = 0;
 };
 
-bool launchQuickStartTitle() {
+bool launchQuickStartTitle(UiSession &session) {
     // Automatically abort quick start if selecting takes longer than 120 seconds or the DRC disconnects
     QuickStartAutoAbort quickStartAutoAbort;
 
@@ -341,10 +341,12 @@ bool launchQuickStartTitle() {
 
         switch (info.mediaType) {
             case nn::sl::NN_SL_MEDIA_TYPE_ODD: {
-                if (!handleDiscInsertScreen(titleIdToLaunch, &titleIdToLaunch)) {
+                if (!handleDiscInsertScreen(session, titleIdToLaunch, &titleIdToLaunch)) {
                     DEBUG_FUNCTION_LINE("Launch Wii U Menu!");
                     return false;
                 }
+                // the splash screen needs GX2
+                session.shutdown();
                 break;
             }
             default: {
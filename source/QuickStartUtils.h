@@ -1,3 +1,5 @@
 #pragma once
 
-bool launchQuickStartTitle();
\ No newline at end of file
+#include "UiSession.h"
+
+bool launchQuickStartTitle(UiSession &session);
\ No newline at end of file
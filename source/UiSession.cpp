@@ -0,0 +1,70 @@
+#include "UiSession.h"
+#include "LatencyMonitor.h"
+#include "MenuUtils.h"
+#include "logger.h"
+#include <coreinit/debug.h>
+#include <coreinit/screen.h>
+#include <coreinit/time.h>
+#include <gx2/state.h>
+#include <malloc.h>
+
+UiSession::~UiSession() {
+    shutdown();
+}
+
+void UiSession::beginScreen(const char *name, std::span<const GlyphPrewarm> prewarm) {
+    OSTime start = OSGetTime();
+    bool reused  = mScreenBuffer != nullptr;
+    if (reused) {
+        DrawUtils::prewarmGlyphs(prewarm);
+    } else {
+        mScreenBuffer = DrawUtils::InitOSScreen();
+        if (!mScreenBuffer) {
+            OSFatal("AutobootModule: Failed to alloc memory for screen");
+        }
+
+        uint32_t tvBufferSize  = DrawUtils::getBufferSize(SCREEN_TV);
+        uint32_t drcBufferSize = DrawUtils::getBufferSize(SCREEN_DRC);
+
+        DrawUtils::initBuffers(mScreenBuffer, tvBufferSize, (uint8_t *) mScreenBuffer + tvBufferSize, drcBufferSize);
+        if (!DrawUtils::initFont(prewarm)) {
+            OSFatal("AutobootModule: Failed to init font");
+        }
+    }
+    LatencyMonitor::setScreen(name);
+    mScreens++;
+    DEBUG_FUNCTION_LINE_INFO("Setup of screen %d (%s) took %lld us (%s)", mScreens, name, OSTicksToMicroseconds(OSGetTime() - start), reused ? "reused" : "new session");
+}
+
+void UiSession::endScreen() {
+    DrawUtils::beginDraw();
+    DrawUtils::clear(COLOR_BLACK);
+    DrawUtils::endDraw();
+}
+
+void UiSession::shutdown() {
+    if (!mScreenBuffer) {
+        return;
+    }
+    OSTime start = OSGetTime();
+
+    uint32_t frames = DrawUtils::getFrameCount();
+    if (frames > 0) {
+        DEBUG_FUNCTION_LINE_INFO("Drew %d frames, %lld us per frame, frames hash %08X", frames, DrawUtils::getDrawTimeUs() / frames, DrawUtils::getFramesHash());
+    }
+
+    DrawUtils::deinitFont();
+    DrawUtils::deinitBuffers();
+
+    if (!DrawUtils::isMemoryBackend()) {
+        // Call GX2Init to shut down OSScreen
+        GX2Init(nullptr);
+    }
+
+    free(mScreenBuffer);
+    mScreenBuffer = nullptr;
+
+    LatencyMonitor::report();
+    DEBUG_FUNCTION_LINE_INFO("Shutdown after %d screens took %lld us", mScreens, OSTicksToMicroseconds(OSGetTime() - start));
+    mScreens = 0;
+}
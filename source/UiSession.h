@@ -0,0 +1,45 @@
+#pragma once
+
+#include "DrawUtils.h"
+#include <cstdint>
+#include <span>
+
+/**
+ * Owns OSScreen, the screen buffers and the font for all screens shown during one boot.
+ *
+ * The first screen sets everything up, consecutive screens only prewarm their glyphs and reuse the rest.
+ * The shutdown of OSScreen happens once, before a title gets launched, or when the session is destroyed.
+ */
+class UiSession {
+public:
+    UiSession() = default;
+
+    ~UiSession();
+
+    UiSession(const UiSession &) = delete;
+
+    UiSession &operator=(const UiSession &) = delete;
+
+    /**
+     * Prepares a screen. The glyphs of the prewarm set get rendered in the background, the name labels the input
+     * latency measured while the screen is shown.
+     */
+    void beginScreen(const char *name, std::span<const GlyphPrewarm> prewarm = {});
+
+    /**
+     * Clears the screen once a screen is done, everything stays set up for the next one.
+     */
+    void endScreen();
+
+    /**
+     * Shuts OSScreen down, frees the screen buffers and the font and reports the input latency. Must be called
+     * before launching a title, does nothing if no screen has been shown.
+     */
+    void shutdown();
+
+    [[nodiscard]] bool isActive() const { return mScreenBuffer != nullptr; }
+
+private:
+    void *mScreenBuffer = nullptr;
+    uint32_t mScreens   = 0;
+};
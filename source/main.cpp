@@ -1,5 +1,6 @@
 #include "BootUtils.h"
 #include "DrawUtils.h"
+#include "InputRecorder.h"
 #include "InputUtils.h"
 #include "MenuUtils.h"
 #include "QuickStartUtils.h"
@@ -25,6 +26,18 @@ int32_t main(int32_t argc, char **argv) {
 
     InputUtils::Init();
 
+    // The config files live next to the module. Load them before the first screen, the quick start may already show one.
+    std::string configDir = argc >= 1 ? std::string(argv[0]) : std::string("fs:/vol/external01/wiiu");
+    InputUtils::loadButtonBindings(configDir + "/autoboot_buttons.cfg");
+    DrawUtils::loadRenderSettings(configDir + "/autoboot_render.cfg");
+    DrawUtils::setGlyphCacheFile(configDir + "/autoboot_glyphs.cache");
+
+#ifdef INPUT_REPLAY
+    InputRecorder::startReplay(INPUT_RECORDING_PATH);
+#elif defined(INPUT_RECORD)
+    InputRecorder::startRecording();
+#endif
+
     initExternalStorage();
 
     // Use librpxloader.
@@ -40,7 +53,10 @@ int32_t main(int32_t argc, char **argv) {
         return 0;
     }
 
-    if (launchQuickStartTitle()) {
+    // shared by all screens of this boot, OSScreen gets shut down once before launching something
+    UiSession uiSession;
+
+    if (launchQuickStartTitle(uiSession)) {
         deinitLogging();
         return 0;
     }
@@ -65,7 +81,7 @@ int32_t main(int32_t argc, char **argv) {
                 if (!AXIsInit()) {
                     AXInit();
                 }
-                handleUpdateWarningScreen();
+                handleUpdateWarningScreen(uiSession);
                 hadMenu = true;
             } else {
                 FSAStat st{};
@@ -87,11 +103,9 @@ int32_t main(int32_t argc, char **argv) {
 
     bool showvHBL          = getVWiiHBLTitleId() != 0;
     bool showHBL           = false;
-    std::string configPath = "fs:/vol/external01/wiiu/autoboot.cfg";
+    std::string configPath = configDir + "/autoboot.cfg";
     if (argc >= 1) {
-        configPath = std::string(argv[0]) + "/autoboot.cfg";
-
-        auto hblInstallerPath = std::string(argv[0]) + "/modules/setup/50_hbl_installer.rpx";
+        auto hblInstallerPath = configDir + "/modules/setup/50_hbl_installer.rpx";
         struct stat st {};
         if (stat(hblInstallerPath.c_str(), &st) >= 0) {
             showHBL = true;
@@ -117,10 +131,15 @@ int32_t main(int32_t argc, char **argv) {
         if (!AXIsInit()) {
             AXInit();
         }
-        bootSelection = handleMenuScreen(configPath, bootSelection, menu);
+        bootSelection = handleMenuScreen(uiSession, configPath, bootSelection, menu);
         hadMenu       = true;
     }
 
+    // only the Homebrew Launcher may still show the account selection
+    if (bootSelection != BOOT_OPTION_HOMEBREW_LAUNCHER || !showHBL) {
+        uiSession.shutdown();
+    }
+
     if (bootSelection >= 0) {
         switch (bootSelection) {
             case BOOT_OPTION_WII_U_MENU:
@@ -131,7 +150,7 @@ int32_t main(int32_t argc, char **argv) {
                     bootWiiUMenu();
                     break;
                 }
-                bootHomebrewLauncher();
+                bootHomebrewLauncher(uiSession);
                 break;
             case BOOT_OPTION_VWII_SYSTEM_MENU:
                 bootvWiiMenu();
@@ -151,6 +170,9 @@ int32_t main(int32_t argc, char **argv) {
         bootWiiUMenu();
     }
 
+#ifdef INPUT_RECORD
+    InputRecorder::saveRecording(INPUT_RECORDING_PATH);
+#endif
     InputUtils::DeInit();
     Mocha_DeInitLibrary();
     deinitLogging();
@@ -63,6 +63,27 @@
 #define GOT_A_SCALE_MATRIX        0x080
 
 /* macros */
+/* Codepoints that get a slot in the direct cmap table. */
+#define DIRECT_CMAP_LOW_END       0x100
+#define DIRECT_CMAP_PUA_START     0xE000
+#define DIRECT_CMAP_PUA_END       0xE100
+#define DIRECT_CMAP_SIZE          (DIRECT_CMAP_LOW_END + (DIRECT_CMAP_PUA_END - DIRECT_CMAP_PUA_START))
+#define DIRECT_CMAP_FAILED        0xFFFF
+
+/* SFT_USE_FLOAT moves outline decoding and rasterization from double to float.
+ * Metrics are still computed in double. */
+#if defined(SFT_USE_FLOAT)
+typedef float Real;
+#define REAL(x)        x##f
+#define REAL_ABS(x)    fabsf(x)
+#define REAL_NEXTAFTER nextafterf
+#else
+typedef double Real;
+#define REAL(x)        x
+#define REAL_ABS(x)    fabs(x)
+#define REAL_NEXTAFTER nextafter
+#endif
+
 #define MIN(a, b)                 ((a) < (b) ? (a) : (b))
 #define SIGN(x)                   (((x) > 0) - ((x) < 0))
 
@@ -78,7 +99,7 @@ typedef struct Outline Outline;
 typedef struct Raster Raster;
 
 struct Point {
-    double x, y;
+    Real x, y;
 };
 struct Line {
     uint_least16_t beg, end;
@@ -87,10 +108,11 @@ struct Curve {
     uint_least16_t beg, end, ctrl;
 };
 struct Cell {
-    double area, cover;
+    Real area, cover;
 };
 
 struct Outline {
+    SFT_Arena *arena;
     Point *points;
     Curve *curves;
     Line *lines;
@@ -119,19 +141,27 @@ struct SFT_Font {
     uint_least16_t unitsPerEm;
     int_least16_t locaFormat;
     uint_least16_t numLongHmtx;
+
+    /* Glyph ids of the hot codepoints, see direct_cmap_slot. NULL if not built. */
+    uint_least16_t *directCmap;
 };
 
 /* function declarations */
 /* generic utility functions */
 void *reallocarray(void *optr, size_t nmemb, size_t size);
-static inline int fast_floor(double x);
-static inline int fast_ceil(double x);
+static inline int fast_floor(Real x);
+static inline int fast_ceil(Real x);
 
 static int init_font(SFT_Font *font);
 /* simple mathematical operations */
 static Point midpoint(Point a, Point b);
-static void transform_points(unsigned int numPts, Point *points, double trf[6]);
+static void transform_points(unsigned int numPts, Point *points, Real trf[6]);
 static void clip_points(unsigned int numPts, Point *points, int width, int height);
+/* scratch memory management */
+static int in_arena(SFT_Arena *arena, void *mem);
+static void *scratch_alloc(SFT_Arena *arena, size_t size);
+static void *scratch_reallocarray(SFT_Arena *arena, void *mem, size_t oldNmemb, size_t nmemb, size_t size);
+static void scratch_free(SFT_Arena *arena, void *mem);
 /* 'outline' data structure management */
 static int init_outline(Outline *outl);
 static void free_outline(Outline *outl);
@@ -154,6 +184,8 @@ static int gettable(SFT_Font *font, char tag[4], uint_fast32_t *offset);
 static int cmap_fmt4(SFT_Font *font, uint_fast32_t table, SFT_UChar charCode, uint_fast32_t *glyph);
 static int cmap_fmt6(SFT_Font *font, uint_fast32_t table, SFT_UChar charCode, uint_fast32_t *glyph);
 static int glyph_id(SFT_Font *font, SFT_UChar charCode, uint_fast32_t *glyph);
+static inline int direct_cmap_slot(SFT_UChar charCode);
+static int init_direct_cmap(SFT_Font *font);
 /* glyph metrics lookup */
 static int hor_metrics(SFT_Font *font, uint_fast32_t glyph, int *advanceWidth, int *leftSideBearing);
 static int glyph_bbox(const SFT *sft, uint_fast32_t outline, int box[4]);
@@ -175,7 +207,11 @@ static void draw_lines(Outline *outl, Raster buf);
 /* post-processing */
 static void post_process(Raster buf, uint8_t *image);
 /* glyph rendering */
-static int render_outline(Outline *outl, double transform[6], SFT_Image image);
+static int render_outline(Outline *outl, Real transform[6], SFT_Image image);
+static int render_glyph(const SFT *sft, SFT_Glyph glyph, SFT_Image image, int padding, int sdf);
+/* distance fields */
+static Real segment_distance2(Point p, Point a, Point b);
+static int distance_field(Outline *outl, SFT_Image image, int padding);
 
 /* function implementations */
 
@@ -184,9 +220,20 @@ sft_version(void) {
     return SCHRIFT_VERSION;
 }
 
+int
+sft_uses_float(void) {
+    return sizeof(Real) == sizeof(float);
+}
+
 /* Loads a font from a user-supplied memory range. */
 SFT_Font *
 sft_loadmem(const void *mem, size_t size) {
+    return sft_loadmem_ex(mem, size, 0);
+}
+
+/* Like sft_loadmem, flags can request additional lookup tables to be built. */
+SFT_Font *
+sft_loadmem_ex(const void *mem, size_t size, int flags) {
     SFT_Font *font;
     if (size > UINT32_MAX) {
         return NULL;
@@ -202,11 +249,16 @@ sft_loadmem(const void *mem, size_t size) {
         sft_freefont(font);
         return NULL;
     }
+    if ((flags & SFT_DIRECT_CMAP) && init_direct_cmap(font) < 0) {
+        sft_freefont(font);
+        return NULL;
+    }
     return font;
 }
 
 void sft_freefont(SFT_Font *font) {
     if (!font) return;
+    free(font->directCmap);
     free(font);
 }
 
@@ -226,6 +278,15 @@ int sft_lmetrics(const SFT *sft, SFT_LMetrics *metrics) {
 }
 
 int sft_lookup(const SFT *sft, SFT_UChar codepoint, SFT_Glyph *glyph) {
+    int slot;
+    if (sft->font->directCmap && (slot = direct_cmap_slot(codepoint)) >= 0) {
+        if (sft->font->directCmap[slot] == DIRECT_CMAP_FAILED) {
+            *glyph = 0;
+            return -1;
+        }
+        *glyph = sft->font->directCmap[slot];
+        return 0;
+    }
     return glyph_id(sft->font, codepoint, glyph);
 }
 
@@ -319,8 +380,21 @@ int sft_kerning(const SFT *sft, SFT_Glyph leftGlyph, SFT_Glyph rightGlyph,
 }
 
 int sft_render(const SFT *sft, SFT_Glyph glyph, SFT_Image image) {
+    return render_glyph(sft, glyph, image, 0, 0);
+}
+
+/* Renders a signed distance field of the glyph. The glyph box gets a border of padding pixels,
+ * distances up to padding pixels are mapped to 0-255 with the outline at 128 and inside > 128. */
+int sft_render_sdf(const SFT *sft, SFT_Glyph glyph, SFT_Image image, int padding) {
+    if (padding < 1)
+        return -1;
+    return render_glyph(sft, glyph, image, padding, 1);
+}
+
+static int
+render_glyph(const SFT *sft, SFT_Glyph glyph, SFT_Image image, int padding, int sdf) {
     uint_fast32_t outline;
-    double transform[6];
+    Real transform[6];
     int bbox[4];
     Outline outl;
 
@@ -334,18 +408,22 @@ int sft_render(const SFT *sft, SFT_Glyph glyph, SFT_Image image) {
 	 * the transformed bounding boxes min corner lines
 	 * up with the (0, 0) point. */
     transform[0] = sft->xScale / sft->font->unitsPerEm;
-    transform[1] = 0.0;
-    transform[2] = 0.0;
-    transform[4] = sft->xOffset - bbox[0];
+    transform[1] = REAL(0.0);
+    transform[2] = REAL(0.0);
+    transform[4] = sft->xOffset - bbox[0] + padding;
     if (sft->flags & SFT_DOWNWARD_Y) {
         transform[3] = -sft->yScale / sft->font->unitsPerEm;
-        transform[5] = bbox[3] - sft->yOffset;
+        transform[5] = bbox[3] - sft->yOffset + padding;
     } else {
         transform[3] = +sft->yScale / sft->font->unitsPerEm;
-        transform[5] = sft->yOffset - bbox[1];
+        transform[5] = sft->yOffset - bbox[1] + padding;
     }
 
     memset(&outl, 0, sizeof outl);
+    /* Nothing from the previous glyph is alive anymore. */
+    outl.arena = sft->arena;
+    if (outl.arena)
+        outl.arena->used = 0;
     if (init_outline(&outl) < 0)
         goto failure;
 
@@ -353,6 +431,8 @@ int sft_render(const SFT *sft, SFT_Glyph glyph, SFT_Image image) {
         goto failure;
     if (render_outline(&outl, transform, image) < 0)
         goto failure;
+    if (sdf && distance_field(&outl, image, padding) < 0)
+        goto failure;
 
     free_outline(&outl);
     return 0;
@@ -379,15 +459,70 @@ reallocarray(void *optr, size_t nmemb, size_t size) {
     return realloc(optr, size * nmemb);
 }
 
+#define ARENA_ALIGN(size) (((size) + 7) & ~(size_t) 7)
+
+static int
+in_arena(SFT_Arena *arena, void *mem) {
+    return arena && mem && (uint8_t *) mem >= (uint8_t *) arena->memory &&
+           (uint8_t *) mem < (uint8_t *) arena->memory + arena->size;
+}
+
+static void *
+scratch_alloc(SFT_Arena *arena, size_t size) {
+    void *mem;
+    if (!arena)
+        return malloc(size);
+    if (arena->size - arena->used < ARENA_ALIGN(size)) {
+        arena->overflows++;
+        return malloc(size);
+    }
+    mem = (uint8_t *) arena->memory + arena->used;
+    arena->used += ARENA_ALIGN(size);
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+    return mem;
+}
+
+/* Grows an array. The most recent arena allocation is grown in place, others are moved. */
+static void *
+scratch_reallocarray(SFT_Arena *arena, void *mem, size_t oldNmemb, size_t nmemb, size_t size) {
+    void *newMem;
+    size_t oldSize, newSize;
+    if (!in_arena(arena, mem))
+        return reallocarray(mem, nmemb, size);
+    if (nmemb > 0 && SIZE_MAX / nmemb < size)
+        return NULL;
+    oldSize = ARENA_ALIGN(oldNmemb * size);
+    newSize = nmemb * size;
+    if ((uint8_t *) mem + oldSize == (uint8_t *) arena->memory + arena->used &&
+        arena->size - (arena->used - oldSize) >= ARENA_ALIGN(newSize)) {
+        arena->used = arena->used - oldSize + ARENA_ALIGN(newSize);
+        if (arena->used > arena->peak)
+            arena->peak = arena->used;
+        return mem;
+    }
+    if (!(newMem = scratch_alloc(arena, newSize)))
+        return NULL;
+    memcpy(newMem, mem, oldNmemb * size);
+    return newMem;
+}
+
+static void
+scratch_free(SFT_Arena *arena, void *mem) {
+    /* arena memory is released as a whole */
+    if (!in_arena(arena, mem))
+        free(mem);
+}
+
 /* TODO maybe we should use long here instead of int. */
 static inline int
-fast_floor(double x) {
+fast_floor(Real x) {
     int i = (int) x;
     return i - (i > x);
 }
 
 static inline int
-fast_ceil(double x) {
+fast_ceil(Real x) {
     int i = (int) x;
     return i + (i < x);
 }
@@ -480,13 +615,13 @@ init_font(SFT_Font *font) {
 static Point
 midpoint(Point a, Point b) {
     return (Point){
-            0.5 * (a.x + b.x),
-            0.5 * (a.y + b.y)};
+            REAL(0.5) * (a.x + b.x),
+            REAL(0.5) * (a.y + b.y)};
 }
 
 /* Applies an affine linear transformation matrix to a set of points. */
 static void
-transform_points(unsigned int numPts, Point *points, double trf[6]) {
+transform_points(unsigned int numPts, Point *points, Real trf[6]) {
     Point pt;
     unsigned int i;
     for (i = 0; i < numPts; ++i) {
@@ -505,17 +640,17 @@ clip_points(unsigned int numPts, Point *points, int width, int height) {
     for (i = 0; i < numPts; ++i) {
         pt = points[i];
 
-        if (pt.x < 0.0) {
-            points[i].x = 0.0;
+        if (pt.x < REAL(0.0)) {
+            points[i].x = REAL(0.0);
         }
         if (pt.x >= width) {
-            points[i].x = nextafter(width, 0.0);
+            points[i].x = REAL_NEXTAFTER((Real) width, REAL(0.0));
         }
-        if (pt.y < 0.0) {
-            points[i].y = 0.0;
+        if (pt.y < REAL(0.0)) {
+            points[i].y = REAL(0.0);
         }
         if (pt.y >= height) {
-            points[i].y = nextafter(height, 0.0);
+            points[i].y = REAL_NEXTAFTER((Real) height, REAL(0.0));
         }
     }
 }
@@ -525,24 +660,24 @@ init_outline(Outline *outl) {
     /* TODO Smaller initial allocations */
     outl->numPoints = 0;
     outl->capPoints = 64;
-    if (!(outl->points = malloc(outl->capPoints * sizeof *outl->points)))
+    if (!(outl->points = scratch_alloc(outl->arena, outl->capPoints * sizeof *outl->points)))
         return -1;
     outl->numCurves = 0;
     outl->capCurves = 64;
-    if (!(outl->curves = malloc(outl->capCurves * sizeof *outl->curves)))
+    if (!(outl->curves = scratch_alloc(outl->arena, outl->capCurves * sizeof *outl->curves)))
         return -1;
     outl->numLines = 0;
     outl->capLines = 64;
-    if (!(outl->lines = malloc(outl->capLines * sizeof *outl->lines)))
+    if (!(outl->lines = scratch_alloc(outl->arena, outl->capLines * sizeof *outl->lines)))
         return -1;
     return 0;
 }
 
 static void
 free_outline(Outline *outl) {
-    free(outl->points);
-    free(outl->curves);
-    free(outl->lines);
+    scratch_free(outl->arena, outl->points);
+    scratch_free(outl->arena, outl->curves);
+    scratch_free(outl->arena, outl->lines);
 }
 
 static int
@@ -554,7 +689,7 @@ grow_points(Outline *outl) {
     if (outl->capPoints > UINT16_MAX / 2)
         return -1;
     cap = (uint_fast16_t) (2U * outl->capPoints);
-    if (!(mem = reallocarray(outl->points, cap, sizeof *outl->points)))
+    if (!(mem = scratch_reallocarray(outl->arena, outl->points, outl->capPoints, cap, sizeof *outl->points)))
         return -1;
     outl->capPoints = (uint_least16_t) cap;
     outl->points    = mem;
@@ -569,7 +704,7 @@ grow_curves(Outline *outl) {
     if (outl->capCurves > UINT16_MAX / 2)
         return -1;
     cap = (uint_fast16_t) (2U * outl->capCurves);
-    if (!(mem = reallocarray(outl->curves, cap, sizeof *outl->curves)))
+    if (!(mem = scratch_reallocarray(outl->arena, outl->curves, outl->capCurves, cap, sizeof *outl->curves)))
         return -1;
     outl->capCurves = (uint_least16_t) cap;
     outl->curves    = mem;
@@ -584,7 +719,7 @@ grow_lines(Outline *outl) {
     if (outl->capLines > UINT16_MAX / 2)
         return -1;
     cap = (uint_fast16_t) (2U * outl->capLines);
-    if (!(mem = reallocarray(outl->lines, cap, sizeof *outl->lines)))
+    if (!(mem = scratch_reallocarray(outl->arena, outl->lines, outl->capLines, cap, sizeof *outl->lines)))
         return -1;
     outl->capLines = (uint_least16_t) cap;
     outl->lines    = mem;
@@ -849,6 +984,35 @@ glyph_id(SFT_Font *font, SFT_UChar charCode, SFT_Glyph *glyph) {
     return -1;
 }
 
+/* Index into the direct cmap table, -1 for codepoints that have to be searched in the cmap. */
+static inline int
+direct_cmap_slot(SFT_UChar charCode) {
+    if (charCode < DIRECT_CMAP_LOW_END)
+        return (int) charCode;
+    if (charCode >= DIRECT_CMAP_PUA_START && charCode < DIRECT_CMAP_PUA_END)
+        return (int) (DIRECT_CMAP_LOW_END + (charCode - DIRECT_CMAP_PUA_START));
+    return -1;
+}
+
+/* Resolves the hot codepoints once, so looking them up doesn't have to search the cmap. */
+static int
+init_direct_cmap(SFT_Font *font) {
+    SFT_UChar charCode;
+    SFT_Glyph glyph;
+    int slot;
+
+    if (!(font->directCmap = malloc(DIRECT_CMAP_SIZE * sizeof *font->directCmap)))
+        return -1;
+    for (slot = 0; slot < DIRECT_CMAP_SIZE; ++slot) {
+        charCode = slot < DIRECT_CMAP_LOW_END ? (SFT_UChar) slot : (SFT_UChar) (DIRECT_CMAP_PUA_START + slot - DIRECT_CMAP_LOW_END);
+        if (glyph_id(font, charCode, &glyph) < 0 || glyph >= DIRECT_CMAP_FAILED)
+            font->directCmap[slot] = DIRECT_CMAP_FAILED;
+        else
+            font->directCmap[slot] = (uint_least16_t) glyph;
+    }
+    return 0;
+}
+
 static int
 hor_metrics(SFT_Font *font, SFT_Glyph glyph, int *advanceWidth, int *leftSideBearing) {
     uint_fast32_t hmtx, offset, boundary;
@@ -981,7 +1145,7 @@ simple_points(SFT_Font *font, uint_fast32_t offset, uint_fast16_t numPts, uint8_
             accum += geti16(font, offset);
             offset += 2;
         }
-        points[i].x = (double) accum;
+        points[i].x = (Real) accum;
     }
 
     accum = 0L;
@@ -998,7 +1162,7 @@ simple_points(SFT_Font *font, uint_fast32_t offset, uint_fast16_t numPts, uint8_
             accum += geti16(font, offset);
             offset += 2;
         }
-        points[i].y = (double) accum;
+        points[i].y = (Real) accum;
     }
 
     return 0;
@@ -1108,14 +1272,16 @@ simple_outline(SFT_Font *font, uint_fast32_t offset, unsigned int numContours, O
             goto failure;
     }
 
-    endPts = calloc(sizeof(uint_fast16_t), numContours);
+    endPts = scratch_alloc(outl->arena, numContours * sizeof(uint_fast16_t));
     if (endPts == NULL) {
         goto failure;
     }
-    flags = calloc(sizeof(uint8_t), numPts);
+    memset(endPts, 0, numContours * sizeof(uint_fast16_t));
+    flags = scratch_alloc(outl->arena, numPts * sizeof(uint8_t));
     if (flags == NULL) {
         goto failure;
     }
+    memset(flags, 0, numPts * sizeof(uint8_t));
 
     for (i = 0; i < numContours; ++i) {
         endPts[i] = getu16(font, offset);
@@ -1144,18 +1310,18 @@ simple_outline(SFT_Font *font, uint_fast32_t offset, unsigned int numContours, O
         beg = endPts[i] + 1;
     }
 
-    free(endPts);
-    free(flags);
+    scratch_free(outl->arena, endPts);
+    scratch_free(outl->arena, flags);
     return 0;
 failure:
-    free(endPts);
-    free(flags);
+    scratch_free(outl->arena, endPts);
+    scratch_free(outl->arena, flags);
     return -1;
 }
 
 static int
 compound_outline(SFT_Font *font, uint_fast32_t offset, int recDepth, Outline *outl) {
-    double local[6];
+    Real local[6];
     uint_fast32_t outline;
     unsigned int flags, glyph, basePoint;
     /* Guard against infinite recursion (compound glyphs that have themselves as component). */
@@ -1188,26 +1354,26 @@ compound_outline(SFT_Font *font, uint_fast32_t offset, int recDepth, Outline *ou
         if (flags & GOT_A_SINGLE_SCALE) {
             if (!is_safe_offset(font, offset, 2))
                 return -1;
-            local[0] = geti16(font, offset) / 16384.0;
+            local[0] = geti16(font, offset) / REAL(16384.0);
             local[3] = local[0];
             offset += 2;
         } else if (flags & GOT_AN_X_AND_Y_SCALE) {
             if (!is_safe_offset(font, offset, 4))
                 return -1;
-            local[0] = geti16(font, offset + 0) / 16384.0;
-            local[3] = geti16(font, offset + 2) / 16384.0;
+            local[0] = geti16(font, offset + 0) / REAL(16384.0);
+            local[3] = geti16(font, offset + 2) / REAL(16384.0);
             offset += 4;
         } else if (flags & GOT_A_SCALE_MATRIX) {
             if (!is_safe_offset(font, offset, 8))
                 return -1;
-            local[0] = geti16(font, offset + 0) / 16384.0;
-            local[1] = geti16(font, offset + 2) / 16384.0;
-            local[2] = geti16(font, offset + 4) / 16384.0;
-            local[3] = geti16(font, offset + 6) / 16384.0;
+            local[0] = geti16(font, offset + 0) / REAL(16384.0);
+            local[1] = geti16(font, offset + 2) / REAL(16384.0);
+            local[2] = geti16(font, offset + 4) / REAL(16384.0);
+            local[3] = geti16(font, offset + 6) / REAL(16384.0);
             offset += 8;
         } else {
-            local[0] = 1.0;
-            local[3] = 1.0;
+            local[0] = REAL(1.0);
+            local[3] = REAL(1.0);
         }
         /* At this point, Apple's spec more or less tells you to scale the matrix by its own L1 norm.
 		 * But stb_truetype scales by the L2 norm. And FreeType2 doesn't scale at all.
@@ -1246,13 +1412,13 @@ decode_outline(SFT_Font *font, uint_fast32_t offset, int recDepth, Outline *outl
 /* A heuristic to tell whether a given curve can be approximated closely enough by a line. */
 static int
 is_flat(Outline *outl, Curve curve) {
-    const double maxArea2 = 2.0;
+    const Real maxArea2   = REAL(2.0);
     Point a               = outl->points[curve.beg];
     Point b               = outl->points[curve.ctrl];
     Point c               = outl->points[curve.end];
     Point g               = {b.x - a.x, b.y - a.y};
     Point h               = {c.x - a.x, c.y - a.y};
-    double area2          = fabs(g.x * h.y - h.x * g.y);
+    Real area2            = REAL_ABS(g.x * h.y - h.x * g.y);
     return area2 <= maxArea2;
 }
 
@@ -1315,9 +1481,9 @@ draw_line(Raster buf, Point origin, Point goal) {
     Point delta;
     Point nextCrossing;
     Point crossingIncr;
-    double halfDeltaX;
-    double prevDistance = 0.0, nextDistance;
-    double xAverage, yDifference;
+    Real halfDeltaX;
+    Real prevDistance = REAL(0.0), nextDistance;
+    Real xAverage, yDifference;
     struct {
         int x, y;
     } pixel;
@@ -1336,12 +1502,12 @@ draw_line(Raster buf, Point origin, Point goal) {
         return;
     }
 
-    crossingIncr.x = dir.x ? fabs(1.0 / delta.x) : 1.0;
-    crossingIncr.y = fabs(1.0 / delta.y);
+    crossingIncr.x = dir.x ? REAL_ABS(REAL(1.0) / delta.x) : REAL(1.0);
+    crossingIncr.y = REAL_ABS(REAL(1.0) / delta.y);
 
     if (!dir.x) {
         pixel.x        = fast_floor(origin.x);
-        nextCrossing.x = 100.0;
+        nextCrossing.x = REAL(100.0);
     } else {
         if (dir.x > 0) {
             pixel.x        = fast_floor(origin.x);
@@ -1367,7 +1533,7 @@ draw_line(Raster buf, Point origin, Point goal) {
     }
 
     nextDistance = MIN(nextCrossing.x, nextCrossing.y);
-    halfDeltaX   = 0.5 * delta.x;
+    halfDeltaX   = REAL(0.5) * delta.x;
 
     for (step = 0; step < numSteps; ++step) {
         xAverage    = origin.x + (prevDistance + nextDistance) * halfDeltaX;
@@ -1375,25 +1541,25 @@ draw_line(Raster buf, Point origin, Point goal) {
         cptr        = &buf.cells[pixel.y * buf.width + pixel.x];
         cell        = *cptr;
         cell.cover += yDifference;
-        xAverage -= (double) pixel.x;
-        cell.area += (1.0 - xAverage) * yDifference;
+        xAverage -= (Real) pixel.x;
+        cell.area += (REAL(1.0) - xAverage) * yDifference;
         *cptr        = cell;
         prevDistance = nextDistance;
         int alongX   = nextCrossing.x < nextCrossing.y;
         pixel.x += alongX ? dir.x : 0;
         pixel.y += alongX ? 0 : dir.y;
-        nextCrossing.x += alongX ? crossingIncr.x : 0.0;
-        nextCrossing.y += alongX ? 0.0 : crossingIncr.y;
+        nextCrossing.x += alongX ? crossingIncr.x : REAL(0.0);
+        nextCrossing.y += alongX ? REAL(0.0) : crossingIncr.y;
         nextDistance = MIN(nextCrossing.x, nextCrossing.y);
     }
 
-    xAverage    = origin.x + (prevDistance + 1.0) * halfDeltaX;
-    yDifference = (1.0 - prevDistance) * delta.y;
+    xAverage    = origin.x + (prevDistance + REAL(1.0)) * halfDeltaX;
+    yDifference = (REAL(1.0) - prevDistance) * delta.y;
     cptr        = &buf.cells[pixel.y * buf.width + pixel.x];
     cell        = *cptr;
     cell.cover += yDifference;
-    xAverage -= (double) pixel.x;
-    cell.area += (1.0 - xAverage) * yDifference;
+    xAverage -= (Real) pixel.x;
+    cell.area += (REAL(1.0) - xAverage) * yDifference;
     *cptr = cell;
 }
 
@@ -1412,28 +1578,28 @@ draw_lines(Outline *outl, Raster buf) {
 static void
 post_process(Raster buf, uint8_t *image) {
     Cell cell;
-    double accum = 0.0, value;
+    Real accum = REAL(0.0), value;
     unsigned int i, num;
     num = (unsigned int) buf.width * (unsigned int) buf.height;
     for (i = 0; i < num; ++i) {
         cell     = buf.cells[i];
-        value    = fabs(accum + cell.area);
-        value    = MIN(value, 1.0);
-        value    = value * 255.0 + 0.5;
+        value    = REAL_ABS(accum + cell.area);
+        value    = MIN(value, REAL(1.0));
+        value    = value * REAL(255.0) + REAL(0.5);
         image[i] = (uint8_t) value;
         accum += cell.cover;
     }
 }
 
 static int
-render_outline(Outline *outl, double transform[6], SFT_Image image) {
+render_outline(Outline *outl, Real transform[6], SFT_Image image) {
     Cell *cells = NULL;
     Raster buf;
     unsigned int numPixels;
 
     numPixels = (unsigned int) image.width * (unsigned int) image.height;
 
-    cells = calloc(sizeof(Cell), numPixels);
+    cells = scratch_alloc(outl->arena, numPixels * sizeof(Cell));
     if (!cells) {
         return -1;
     }
@@ -1447,7 +1613,7 @@ render_outline(Outline *outl, double transform[6], SFT_Image image) {
     clip_points(outl->numPoints, outl->points, image.width, image.height);
 
     if (tesselate_curves(outl) < 0) {
-        free(cells);
+        scratch_free(outl->arena, cells);
         return -1;
     }
 
@@ -1455,6 +1621,70 @@ render_outline(Outline *outl, double transform[6], SFT_Image image) {
 
     post_process(buf, image.pixels);
 
-    free(cells);
+    scratch_free(outl->arena, cells);
+    return 0;
+}
+
+/* Squared distance between p and the segment from a to b. */
+static Real
+segment_distance2(Point p, Point a, Point b) {
+    Point ab = {b.x - a.x, b.y - a.y};
+    Point ap = {p.x - a.x, p.y - a.y};
+    Real len2 = ab.x * ab.x + ab.y * ab.y;
+    Real t    = len2 > REAL(0.0) ? (ap.x * ab.x + ap.y * ab.y) / len2 : REAL(0.0);
+    t         = t < REAL(0.0) ? REAL(0.0) : (t > REAL(1.0) ? REAL(1.0) : t);
+    ap.x -= t * ab.x;
+    ap.y -= t * ab.y;
+    return ap.x * ap.x + ap.y * ap.y;
+}
+
+/* Replaces the coverage in image with the signed distance of each pixel center to the tesselated outline.
+ * Whether a pixel is inside is taken from its coverage. Distances are clamped to padding, so each line only
+ * has to visit the pixels within padding of its bounding box instead of every line visiting every pixel. */
+static int
+distance_field(Outline *outl, SFT_Image image, int padding) {
+    uint8_t *pixels = image.pixels;
+    Real *best;
+    Point a, b, center;
+    Real limit, dist, value;
+    int x, y, x0, y0, x1, y1;
+    unsigned int i, numPixels;
+
+    numPixels = (unsigned int) image.width * (unsigned int) image.height;
+    best      = scratch_alloc(outl->arena, numPixels * sizeof *best);
+    if (!best)
+        return -1;
+    limit = (Real) (padding * padding);
+    for (i = 0; i < numPixels; ++i)
+        best[i] = limit;
+
+    for (i = 0; i < outl->numLines; ++i) {
+        a = outl->points[outl->lines[i].beg];
+        b = outl->points[outl->lines[i].end];
+        /* pixel centers at most padding away from the bounding box of the line */
+        x0 = (int) ceil(MIN(a.x, b.x) - (Real) padding - REAL(0.5));
+        y0 = (int) ceil(MIN(a.y, b.y) - (Real) padding - REAL(0.5));
+        x1 = (int) floor((a.x > b.x ? a.x : b.x) + (Real) padding - REAL(0.5));
+        y1 = (int) floor((a.y > b.y ? a.y : b.y) + (Real) padding - REAL(0.5));
+        x0 = x0 < 0 ? 0 : x0;
+        y0 = y0 < 0 ? 0 : y0;
+        x1 = MIN(x1, image.width - 1);
+        y1 = MIN(y1, image.height - 1);
+        for (y = y0; y <= y1; ++y) {
+            for (x = x0; x <= x1; ++x) {
+                center = (Point){(Real) x + REAL(0.5), (Real) y + REAL(0.5)};
+                dist   = segment_distance2(center, a, b);
+                best[y * image.width + x] = MIN(best[y * image.width + x], dist);
+            }
+        }
+    }
+
+    for (i = 0; i < numPixels; ++i) {
+        dist      = (Real) sqrt(best[i]) / (Real) padding;
+        value     = pixels[i] >= 128 ? REAL(128.0) + dist * REAL(127.0) : REAL(128.0) - dist * REAL(128.0);
+        value     = value < REAL(0.0) ? REAL(0.0) : MIN(value, REAL(255.0));
+        pixels[i] = (uint8_t) (value + REAL(0.5));
+    }
+    scratch_free(outl->arena, best);
     return 0;
 }
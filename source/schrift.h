@@ -26,6 +26,9 @@ extern "C" {
 
 #define SFT_DOWNWARD_Y 0x01
 
+/* sft_loadmem_ex flags */
+#define SFT_DIRECT_CMAP 0x01 /* O(1) lookups for Latin-1 and U+E000-U+E0FF */
+
 typedef struct SFT SFT;
 typedef struct SFT_Font SFT_Font;
 typedef uint_least32_t SFT_UChar; /* Guaranteed to be compatible with char32_t. */
@@ -34,6 +37,7 @@ typedef struct SFT_LMetrics SFT_LMetrics;
 typedef struct SFT_GMetrics SFT_GMetrics;
 typedef struct SFT_Kerning SFT_Kerning;
 typedef struct SFT_Image SFT_Image;
+typedef struct SFT_Arena SFT_Arena;
 
 struct SFT {
     SFT_Font *font;
@@ -42,6 +46,18 @@ struct SFT {
     double xOffset;
     double yOffset;
     int flags;
+    SFT_Arena *arena; /* optional, see SFT_Arena */
+};
+
+/* Caller-owned scratch memory for sft_render. The outline and raster buffers of a glyph are
+ * bump-allocated from it and released when the next glyph gets rendered. Allocations that don't
+ * fit fall back to malloc and are counted as overflows. */
+struct SFT_Arena {
+    void *memory;
+    size_t size;
+    size_t used;
+    size_t peak; /* highest usage seen so far, to tune the size */
+    unsigned long overflows;
 };
 
 struct SFT_LMetrics {
@@ -70,8 +86,11 @@ struct SFT_Image {
 };
 
 const char *sft_version(void);
+/* 1 if the rasterizer was built with SFT_USE_FLOAT, so its coverage may differ slightly. */
+int sft_uses_float(void);
 
 SFT_Font *sft_loadmem(const void *mem, size_t size);
+SFT_Font *sft_loadmem_ex(const void *mem, size_t size, int flags);
 void sft_freefont(SFT_Font *font);
 
 int sft_lmetrics(const SFT *sft, SFT_LMetrics *metrics);
@@ -80,6 +99,7 @@ int sft_gmetrics(const SFT *sft, SFT_Glyph glyph, SFT_GMetrics *metrics);
 int sft_kerning(const SFT *sft, SFT_Glyph leftGlyph, SFT_Glyph rightGlyph,
                 SFT_Kerning *kerning);
 int sft_render(const SFT *sft, SFT_Glyph glyph, SFT_Image image);
+int sft_render_sdf(const SFT *sft, SFT_Glyph glyph, SFT_Image image, int padding);
 
 #ifdef __cplusplus
 }
@@ -1,14 +1,69 @@
+#include "utils.h"
 #include "logger.h"
+#include <atomic>
 #include <coreinit/filesystem_fsa.h>
 #include <coreinit/mcp.h>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <mocha/mocha.h>
+#include <new>
 #include <string_view>
 #include <sys/stat.h>
 #include <vector>
 #include <whb/log.h>
 
+#ifdef DEBUG
+// Counts every allocation done with new, so hot paths that should not allocate can be checked.
+static std::atomic<uint32_t> sAllocationCount = 0;
+
+void *operator new(size_t size) {
+    sAllocationCount++;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    sAllocationCount++;
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+uint32_t GetAllocationCount() {
+    return sAllocationCount;
+}
+#else
+uint32_t GetAllocationCount() {
+    return 0;
+}
+#endif
+
 bool GetTitleIdOfDisc(uint64_t *titleId, bool *discPresent) {
     if (discPresent) {
         *discPresent = false;
@@ -105,4 +160,14 @@ bool LoadFileIntoBuffer(std::string_view path, std::vector<uint8_t> &buffer) {
 
     fclose(f);
     return true;
+}
+
+std::string_view TrimWhitespace(std::string_view str) {
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t' || str.back() == '\r' || str.back() == '\n')) {
+        str.remove_suffix(1);
+    }
+    return str;
 }
\ No newline at end of file
@@ -36,4 +36,14 @@ bool DeleteMLCUpdateDirectory();
 
 bool RestoreMLCUpdateDirectory();
 
-bool LoadFileIntoBuffer(std::string_view path, std::vector<uint8_t> &buffer);
\ No newline at end of file
+bool LoadFileIntoBuffer(std::string_view path, std::vector<uint8_t> &buffer);
+
+/**
+ * Strips spaces, tabs and line endings from both ends, e.g. of a line read from a config file.
+ */
+std::string_view TrimWhitespace(std::string_view str);
+
+/**
+ * Number of allocations done with new so far. Only counted in DEBUG builds, otherwise always 0.
+ */
+uint32_t GetAllocationCount();
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "DrawUtils.h"
+#include <cstdint>
+
+// Rounded division by 255 in fixed point, exact for every product of two 8 bit values.
+inline uint32_t Div255(uint32_t value) {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+/**
+ * Fills count pixels with a color, blending it with straight alpha if it isn't opaque.
+ */
+inline void FillSpan(uint32_t *dst, uint32_t count, Color col) {
+    if (col.a == 0xFF) {
+        uint32_t value = col.color;
+        for (uint32_t i = 0; i < count; i++) {
+            dst[i] = value;
+        }
+        return;
+    } else if (col.a == 0) {
+        return;
+    }
+
+    // the source part of the blend is the same for the whole row
+    uint32_t invAlpha = 255 - col.a;
+    uint32_t srcR     = col.r * col.a;
+    uint32_t srcG     = col.g * col.a;
+    uint32_t srcB     = col.b * col.a;
+    for (uint32_t i = 0; i < count; i++) {
+        Color pixel(dst[i]);
+        pixel.r = Div255(srcR + pixel.r * invAlpha);
+        pixel.g = Div255(srcG + pixel.g * invAlpha);
+        pixel.b = Div255(srcB + pixel.b * invAlpha);
+        dst[i]  = pixel.color;
+    }
+}
+
+/**
+ * Blends one pixel of a color with the given alpha instead of its own, 0 and 0xFF are handled by the callers.
+ */
+inline uint32_t BlendColor(uint32_t dst, Color col, uint32_t alpha) {
+    uint32_t invAlpha = 255 - alpha;
+    Color pixel(dst);
+    pixel.r = Div255(col.r * alpha + pixel.r * invAlpha);
+    pixel.g = Div255(col.g * alpha + pixel.g * invAlpha);
+    pixel.b = Div255(col.b * alpha + pixel.b * invAlpha);
+    return pixel.color;
+}
+
+/**
+ * Blends a premultiplied pixel that is neither transparent nor opaque over dst.
+ */
+inline uint32_t BlendPremultiplied(uint32_t dst, Color src) {
+    Color out(dst);
+    uint32_t invAlpha = 255 - src.a;
+    out.r             = src.r + Div255(out.r * invAlpha);
+    out.g             = src.g + Div255(out.g * invAlpha);
+    out.b             = src.b + Div255(out.b * invAlpha);
+    return out.color;
+}
+
+/**
+ * Fills the blended alpha of a color with the given alpha for each coverage value of a glyph.
+ */
+inline void BuildCoverageAlphaTable(uint8_t *table, uint8_t alpha) {
+    for (uint32_t i = 0; i < 256; i++) {
+        table[i] = i == 0xFF ? alpha : Div255(alpha * i);
+    }
+}
+
+/**
+ * Blends a run of pixels of a color with the given coverage into dst. opaque is the color with full alpha.
+ */
+inline void BlendCoverageRun(uint32_t *dst, const uint8_t *coverage, uint32_t count, const uint8_t *alphaTable, Color col, uint32_t opaque) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t alpha = alphaTable[coverage[i]];
+        if (alpha == 0xFF) {
+            dst[i] = opaque;
+        } else if (alpha != 0) {
+            dst[i] = BlendColor(dst[i], col, alpha);
+        }
+    }
+}
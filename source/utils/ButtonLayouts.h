@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ButtonRemap.h"
+#include <padscore/wpad.h>
+#include <vpad/input.h>
+
+// GamePad buttons the Wii Remote, Classic Controller and Pro Controller buttons map to by default. The menus only
+// know GamePad buttons.
+
+inline constexpr ButtonBinding WIIMOTE_BINDINGS[] = {
+        {WPAD_BUTTON_LEFT, VPAD_BUTTON_LEFT},
+        {WPAD_BUTTON_RIGHT, VPAD_BUTTON_RIGHT},
+        {WPAD_BUTTON_DOWN, VPAD_BUTTON_DOWN},
+        {WPAD_BUTTON_UP, VPAD_BUTTON_UP},
+        {WPAD_BUTTON_PLUS, VPAD_BUTTON_PLUS},
+        {WPAD_BUTTON_2, VPAD_BUTTON_Y},
+        {WPAD_BUTTON_1, VPAD_BUTTON_X},
+        {WPAD_BUTTON_B, VPAD_BUTTON_B},
+        {WPAD_BUTTON_A, VPAD_BUTTON_A},
+        {WPAD_BUTTON_MINUS, VPAD_BUTTON_MINUS},
+        {WPAD_BUTTON_HOME, VPAD_BUTTON_HOME},
+};
+
+inline constexpr ButtonBinding CLASSIC_BINDINGS[] = {
+        {WPAD_CLASSIC_BUTTON_LEFT, VPAD_BUTTON_LEFT},
+        {WPAD_CLASSIC_BUTTON_RIGHT, VPAD_BUTTON_RIGHT},
+        {WPAD_CLASSIC_BUTTON_DOWN, VPAD_BUTTON_DOWN},
+        {WPAD_CLASSIC_BUTTON_UP, VPAD_BUTTON_UP},
+        {WPAD_CLASSIC_BUTTON_PLUS, VPAD_BUTTON_PLUS},
+        {WPAD_CLASSIC_BUTTON_X, VPAD_BUTTON_X},
+        {WPAD_CLASSIC_BUTTON_Y, VPAD_BUTTON_Y},
+        {WPAD_CLASSIC_BUTTON_B, VPAD_BUTTON_B},
+        {WPAD_CLASSIC_BUTTON_A, VPAD_BUTTON_A},
+        {WPAD_CLASSIC_BUTTON_MINUS, VPAD_BUTTON_MINUS},
+        {WPAD_CLASSIC_BUTTON_HOME, VPAD_BUTTON_HOME},
+        {WPAD_CLASSIC_BUTTON_ZR, VPAD_BUTTON_ZR},
+        {WPAD_CLASSIC_BUTTON_ZL, VPAD_BUTTON_ZL},
+        {WPAD_CLASSIC_BUTTON_R, VPAD_BUTTON_R},
+        {WPAD_CLASSIC_BUTTON_L, VPAD_BUTTON_L},
+};
+
+inline constexpr ButtonBinding PRO_BINDINGS[] = {
+        {WPAD_PRO_BUTTON_LEFT, VPAD_BUTTON_LEFT},
+        {WPAD_PRO_BUTTON_RIGHT, VPAD_BUTTON_RIGHT},
+        {WPAD_PRO_BUTTON_DOWN, VPAD_BUTTON_DOWN},
+        {WPAD_PRO_BUTTON_UP, VPAD_BUTTON_UP},
+        {WPAD_PRO_BUTTON_PLUS, VPAD_BUTTON_PLUS},
+        {WPAD_PRO_BUTTON_X, VPAD_BUTTON_X},
+        {WPAD_PRO_BUTTON_Y, VPAD_BUTTON_Y},
+        {WPAD_PRO_BUTTON_B, VPAD_BUTTON_B},
+        {WPAD_PRO_BUTTON_A, VPAD_BUTTON_A},
+        {WPAD_PRO_BUTTON_MINUS, VPAD_BUTTON_MINUS},
+        {WPAD_PRO_BUTTON_HOME, VPAD_BUTTON_HOME},
+        {WPAD_PRO_TRIGGER_ZR, VPAD_BUTTON_ZR},
+        {WPAD_PRO_TRIGGER_ZL, VPAD_BUTTON_ZL},
+        {WPAD_PRO_TRIGGER_R, VPAD_BUTTON_R},
+        {WPAD_PRO_TRIGGER_L, VPAD_BUTTON_L},
+        {WPAD_PRO_BUTTON_STICK_R, VPAD_BUTTON_STICK_R},
+        {WPAD_PRO_BUTTON_STICK_L, VPAD_BUTTON_STICK_L},
+};
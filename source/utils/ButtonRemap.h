@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+struct ButtonBinding {
+    uint32_t from;
+    uint32_t to;
+};
+
+/**
+ * Maps the button mask of one controller type to another through one 16 entry table per nibble, so a mask of up
+ * to 20 buttons takes five lookups no matter how many buttons are pressed.
+ *
+ * The default maps are built at compile time. Changing a binding rebuilds the tables, the lookup stays the same.
+ */
+class ButtonRemap {
+public:
+    static constexpr uint32_t MAX_BUTTONS = 20;
+
+    constexpr ButtonRemap() = default;
+
+    constexpr explicit ButtonRemap(std::span<const ButtonBinding> bindings) {
+        for (const auto &binding : bindings) {
+            for (uint32_t bit = 0; bit < MAX_BUTTONS; bit++) {
+                if (binding.from & (1u << bit)) {
+                    mTargets[bit] |= binding.to;
+                }
+            }
+        }
+        buildTables();
+    }
+
+    [[nodiscard]] constexpr uint32_t map(uint32_t buttons) const {
+        uint32_t result = 0;
+        for (uint32_t nibble = 0; nibble < NIBBLES; nibble++) {
+            result |= mTables[nibble][(buttons >> (nibble * 4)) & 0xF];
+        }
+        return result;
+    }
+
+    /**
+     * Replaces what the buttons in from map to. A target of 0 unbinds them.
+     */
+    constexpr void rebind(uint32_t from, uint32_t to) {
+        for (uint32_t bit = 0; bit < MAX_BUTTONS; bit++) {
+            if (from & (1u << bit)) {
+                mTargets[bit] = to;
+            }
+        }
+        buildTables();
+    }
+
+private:
+    static constexpr uint32_t NIBBLES = MAX_BUTTONS / 4;
+
+    constexpr void buildTables() {
+        for (uint32_t nibble = 0; nibble < NIBBLES; nibble++) {
+            for (uint32_t value = 0; value < 16; value++) {
+                uint32_t mapped = 0;
+                for (uint32_t bit = 0; bit < 4; bit++) {
+                    if (value & (1u << bit)) {
+                        mapped |= mTargets[nibble * 4 + bit];
+                    }
+                }
+                mTables[nibble][value] = mapped;
+            }
+        }
+    }
+
+    uint32_t mTargets[MAX_BUTTONS] = {};
+    uint32_t mTables[NIBBLES][16]  = {};
+};
@@ -0,0 +1,172 @@
+#include "GlyphCache.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <vector>
+
+GlyphCache::GlyphCache(uint32_t arenaSize, uint32_t maxEntries) {
+    mArena       = (uint8_t *) memalign(0x40, arenaSize);
+    mEntries     = (Entry *) malloc(maxEntries * sizeof(Entry));
+    mBucketCount = maxEntries;
+    mBuckets     = (int32_t *) malloc(mBucketCount * sizeof(int32_t));
+    if (!isValid()) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to allocate glyph cache");
+        return;
+    }
+    mArenaSize  = arenaSize;
+    mMaxEntries = maxEntries;
+    clear();
+}
+
+GlyphCache::~GlyphCache() {
+    free(mArena);
+    free(mEntries);
+    free(mBuckets);
+}
+
+void GlyphCache::clear() {
+    if (!isValid()) {
+        return;
+    }
+    for (uint32_t i = 0; i < mBucketCount; i++) {
+        mBuckets[i] = -1;
+    }
+    for (uint32_t i = 0; i < mMaxEntries; i++) {
+        mEntries[i].used = false;
+        mEntries[i].next = (i + 1 < mMaxEntries) ? (int32_t) (i + 1) : -1;
+    }
+    mFreeList    = mMaxEntries > 0 ? 0 : -1;
+    mArenaOffset = 0;
+    mUsedBytes   = 0;
+}
+
+uint32_t GlyphCache::bucketOf(uint32_t codepoint, uint32_t fontSize) const {
+    return ((codepoint * 0x9E3779B1u) ^ (fontSize * 0x85EBCA6Bu)) % mBucketCount;
+}
+
+int32_t GlyphCache::findEntry(uint32_t codepoint, uint32_t fontSize) const {
+    if (!isValid()) {
+        return -1;
+    }
+    for (int32_t i = mBuckets[bucketOf(codepoint, fontSize)]; i >= 0; i = mEntries[i].next) {
+        if (mEntries[i].glyph.codepoint == codepoint && mEntries[i].glyph.fontSize == fontSize) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const CachedGlyph *GlyphCache::find(uint32_t codepoint, uint32_t fontSize) {
+    int32_t index = findEntry(codepoint, fontSize);
+    if (index < 0) {
+        mMisses++;
+        return nullptr;
+    }
+    mHits++;
+    mEntries[index].lastUse = ++mUseCounter;
+    return &mEntries[index].glyph;
+}
+
+void GlyphCache::unlink(int32_t index) {
+    Entry &entry = mEntries[index];
+    int32_t *cur = &mBuckets[bucketOf(entry.glyph.codepoint, entry.glyph.fontSize)];
+    while (*cur >= 0 && *cur != index) {
+        cur = &mEntries[*cur].next;
+    }
+    if (*cur == index) {
+        *cur = entry.next;
+    }
+    mUsedBytes -= entry.size;
+    entry.used = false;
+    entry.next = mFreeList;
+    mFreeList  = index;
+}
+
+void GlyphCache::remove(uint32_t codepoint, uint32_t fontSize) {
+    int32_t index = findEntry(codepoint, fontSize);
+    if (index >= 0) {
+        unlink(index);
+    }
+}
+
+bool GlyphCache::evictLeastRecentlyUsed() {
+    int32_t oldest = -1;
+    for (uint32_t i = 0; i < mMaxEntries; i++) {
+        if (mEntries[i].used && (oldest < 0 || mEntries[i].lastUse < mEntries[oldest].lastUse)) {
+            oldest = (int32_t) i;
+        }
+    }
+    if (oldest < 0) {
+        return false;
+    }
+    unlink(oldest);
+    mEvictions++;
+    return true;
+}
+
+void GlyphCache::compact() {
+    // Slide all bitmaps to the start of the arena, keeping their order.
+    std::vector<int32_t> order;
+    for (uint32_t i = 0; i < mMaxEntries; i++) {
+        if (mEntries[i].used) {
+            order.push_back((int32_t) i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [this](int32_t a, int32_t b) { return mEntries[a].offset < mEntries[b].offset; });
+
+    uint32_t offset = 0;
+    for (int32_t index : order) {
+        Entry &entry = mEntries[index];
+        if (entry.offset != offset) {
+            memmove(mArena + offset, mArena + entry.offset, entry.size);
+            entry.offset = offset;
+        }
+        entry.glyph.pixels = entry.size > 0 ? mArena + offset : nullptr;
+        offset += entry.size;
+    }
+    mArenaOffset = offset;
+}
+
+CachedGlyph *GlyphCache::insert(uint32_t codepoint, uint32_t fontSize, uint32_t bitmapSize) {
+    // keep bitmaps 4 byte aligned
+    bitmapSize = (bitmapSize + 3) & ~3;
+    if (!isValid() || bitmapSize > mArenaSize) {
+        return nullptr;
+    }
+    remove(codepoint, fontSize);
+
+    while (mFreeList < 0 || mUsedBytes + bitmapSize > mArenaSize) {
+        if (!evictLeastRecentlyUsed()) {
+            return nullptr;
+        }
+    }
+    if (mArenaOffset + bitmapSize > mArenaSize) {
+        compact();
+    }
+
+    int32_t index = mFreeList;
+    Entry &entry  = mEntries[index];
+    mFreeList     = entry.next;
+
+    entry.used    = true;
+    entry.offset  = mArenaOffset;
+    entry.size    = bitmapSize;
+    entry.lastUse = ++mUseCounter;
+    entry.glyph   = {};
+
+    entry.glyph.codepoint = codepoint;
+    entry.glyph.fontSize  = fontSize;
+    entry.glyph.pixels    = bitmapSize > 0 ? mArena + mArenaOffset : nullptr;
+
+    mArenaOffset += bitmapSize;
+    mUsedBytes += bitmapSize;
+    mInsertions++;
+
+    uint32_t bucket  = bucketOf(codepoint, fontSize);
+    entry.next       = mBuckets[bucket];
+    mBuckets[bucket] = index;
+
+    return &entry.glyph;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Rendered glyph with the metrics needed to place it.
+ */
+struct CachedGlyph {
+    uint32_t codepoint;
+    uint32_t fontSize;
+    double advanceWidth;
+    double leftSideBearing;
+    int32_t yOffset;
+    int32_t minHeight;
+    // size of the coverage bitmap, width is padded to a multiple of 4
+    int32_t width;
+    int32_t height;
+    uint8_t *pixels;
+};
+
+/**
+ * Cache of rendered glyphs keyed by (codepoint, font size).
+ *
+ * The coverage bitmaps live in a fixed-size arena. When the arena or the entry table is full the least
+ * recently used glyphs are evicted and the arena gets compacted.
+ */
+class GlyphCache {
+public:
+    GlyphCache(uint32_t arenaSize, uint32_t maxEntries);
+
+    ~GlyphCache();
+
+    GlyphCache(const GlyphCache &) = delete;
+
+    GlyphCache &operator=(const GlyphCache &) = delete;
+
+    [[nodiscard]] bool isValid() const { return mArena != nullptr && mEntries != nullptr && mBuckets != nullptr; }
+
+    /**
+     * Returns the cached glyph or nullptr. Counts as a use for the LRU eviction.
+     */
+    const CachedGlyph *find(uint32_t codepoint, uint32_t fontSize);
+
+    [[nodiscard]] bool contains(uint32_t codepoint, uint32_t fontSize) const { return findEntry(codepoint, fontSize) >= 0; }
+
+    /**
+     * Adds a glyph with room for a bitmap of bitmapSize bytes. The caller fills in the metrics and the pixels.
+     * Returns nullptr if the bitmap doesn't fit into the arena at all.
+     */
+    CachedGlyph *insert(uint32_t codepoint, uint32_t fontSize, uint32_t bitmapSize);
+
+    /**
+     * Removes a glyph, e.g. when rendering into the memory returned by insert failed.
+     */
+    void remove(uint32_t codepoint, uint32_t fontSize);
+
+    void clear();
+
+    /**
+     * Calls func for every cached glyph, least recently used first.
+     */
+    template<typename Func>
+    void forEach(Func func) const {
+        uint32_t lastUse = 0;
+        while (true) {
+            // cheap enough for the few hundred entries we have, and keeps the LRU order when loading them again
+            const Entry *next = nullptr;
+            for (uint32_t i = 0; i < mMaxEntries; i++) {
+                if (mEntries[i].used && mEntries[i].lastUse > lastUse && (!next || mEntries[i].lastUse < next->lastUse)) {
+                    next = &mEntries[i];
+                }
+            }
+            if (!next) {
+                break;
+            }
+            func(next->glyph);
+            lastUse = next->lastUse;
+        }
+    }
+
+    [[nodiscard]] uint32_t getHits() const { return mHits; }
+
+    [[nodiscard]] uint32_t getMisses() const { return mMisses; }
+
+    [[nodiscard]] uint32_t getEvictions() const { return mEvictions; }
+
+    [[nodiscard]] uint32_t getUsedBytes() const { return mUsedBytes; }
+
+    [[nodiscard]] uint32_t getInsertions() const { return mInsertions; }
+
+private:
+    struct Entry {
+        CachedGlyph glyph;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t lastUse;
+        int32_t next; // next entry in the same bucket or in the free list
+        bool used;
+    };
+
+    [[nodiscard]] uint32_t bucketOf(uint32_t codepoint, uint32_t fontSize) const;
+
+    int32_t findEntry(uint32_t codepoint, uint32_t fontSize) const;
+
+    void unlink(int32_t index);
+
+    bool evictLeastRecentlyUsed();
+
+    void compact();
+
+    uint8_t *mArena       = nullptr;
+    uint32_t mArenaSize   = 0;
+    uint32_t mArenaOffset = 0;
+    uint32_t mUsedBytes   = 0;
+    Entry *mEntries       = nullptr;
+    uint32_t mMaxEntries  = 0;
+    int32_t *mBuckets     = nullptr;
+    uint32_t mBucketCount = 0;
+    int32_t mFreeList     = -1;
+    uint32_t mUseCounter  = 0;
+    uint32_t mHits        = 0;
+    uint32_t mMisses      = 0;
+    uint32_t mEvictions   = 0;
+    uint32_t mInsertions  = 0;
+};
@@ -0,0 +1,148 @@
+#include "GlyphCacheFile.h"
+#include "logger.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define GLYPH_CACHE_FILE_MAGIC   0x47434631 // "GCF1"
+#define GLYPH_CACHE_FILE_VERSION 1
+
+struct GlyphCacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t key;
+    uint32_t glyphCount;
+    uint32_t dataSize;
+    uint32_t checksum; // of the data following the header
+};
+
+struct GlyphCacheFileRecord {
+    uint32_t codepoint;
+    uint32_t fontSize;
+    double advanceWidth;
+    double leftSideBearing;
+    int32_t yOffset;
+    int32_t minHeight;
+    int32_t width;
+    int32_t height;
+    // followed by width * height bytes of coverage
+};
+
+uint32_t HashGlyphData(const void *data, size_t size, uint32_t hash) {
+    auto *bytes = (const uint8_t *) data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+bool LoadGlyphCacheFile(std::string_view path, uint32_t key, GlyphCache &cache) {
+    std::vector<uint8_t> buffer;
+    if (!LoadFileIntoBuffer(path, buffer)) {
+        return false;
+    }
+
+    GlyphCacheFileHeader header;
+    if (buffer.size() < sizeof(header)) {
+        DEBUG_FUNCTION_LINE_WARN("Glyph cache file is truncated");
+        return false;
+    }
+    memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != GLYPH_CACHE_FILE_MAGIC || header.version != GLYPH_CACHE_FILE_VERSION) {
+        DEBUG_FUNCTION_LINE_WARN("Ignoring glyph cache file of an unknown version");
+        return false;
+    }
+    if (header.key != key) {
+        DEBUG_FUNCTION_LINE_INFO("Ignoring stale glyph cache file");
+        return false;
+    }
+    if (header.dataSize != buffer.size() - sizeof(header) || HashGlyphData(buffer.data() + sizeof(header), header.dataSize) != header.checksum) {
+        DEBUG_FUNCTION_LINE_WARN("Ignoring corrupt glyph cache file");
+        return false;
+    }
+
+    // Everything is validated before the first glyph goes into the cache
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.glyphCount; i++) {
+        GlyphCacheFileRecord record;
+        if (buffer.size() - offset < sizeof(record)) {
+            return false;
+        }
+        memcpy(&record, buffer.data() + offset, sizeof(record));
+        offset += sizeof(record);
+        if (record.width < 0 || record.height < 0 || (record.width & 3) != 0 || buffer.size() - offset < (size_t) record.width * record.height) {
+            return false;
+        }
+        offset += (size_t) record.width * record.height;
+    }
+    if (offset != buffer.size()) {
+        return false;
+    }
+
+    offset = sizeof(header);
+    for (uint32_t i = 0; i < header.glyphCount; i++) {
+        GlyphCacheFileRecord record;
+        memcpy(&record, buffer.data() + offset, sizeof(record));
+        offset += sizeof(record);
+        uint32_t bitmapSize = (uint32_t) (record.width * record.height);
+
+        CachedGlyph *glyph = cache.insert(record.codepoint, record.fontSize, bitmapSize);
+        if (glyph) {
+            glyph->advanceWidth    = record.advanceWidth;
+            glyph->leftSideBearing = record.leftSideBearing;
+            glyph->yOffset         = record.yOffset;
+            glyph->minHeight       = record.minHeight;
+            glyph->width           = record.width;
+            glyph->height          = record.height;
+            if (bitmapSize > 0) {
+                memcpy(glyph->pixels, buffer.data() + offset, bitmapSize);
+            }
+        }
+        offset += bitmapSize;
+    }
+    return true;
+}
+
+bool SaveGlyphCacheFile(std::string_view path, uint32_t key, const GlyphCache &cache) {
+    std::vector<uint8_t> buffer(sizeof(GlyphCacheFileHeader));
+    GlyphCacheFileHeader header = {};
+    header.magic                = GLYPH_CACHE_FILE_MAGIC;
+    header.version              = GLYPH_CACHE_FILE_VERSION;
+    header.key                  = key;
+
+    cache.forEach([&buffer, &header](const CachedGlyph &glyph) {
+        GlyphCacheFileRecord record = {
+                .codepoint       = glyph.codepoint,
+                .fontSize        = glyph.fontSize,
+                .advanceWidth    = glyph.advanceWidth,
+                .leftSideBearing = glyph.leftSideBearing,
+                .yOffset         = glyph.yOffset,
+                .minHeight       = glyph.minHeight,
+                .width           = glyph.width,
+                .height          = glyph.height,
+        };
+        auto *recordBytes = (const uint8_t *) &record;
+        buffer.insert(buffer.end(), recordBytes, recordBytes + sizeof(record));
+        if (glyph.width > 0 && glyph.height > 0) {
+            buffer.insert(buffer.end(), glyph.pixels, glyph.pixels + glyph.width * glyph.height);
+        }
+        header.glyphCount++;
+    });
+
+    header.dataSize = buffer.size() - sizeof(header);
+    header.checksum = HashGlyphData(buffer.data() + sizeof(header), header.dataSize);
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    FILE *f = fopen(path.data(), "wb");
+    if (!f) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to open %s", path.data());
+        return false;
+    }
+    bool res = fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+    fclose(f);
+    if (!res) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to write %s", path.data());
+    }
+    return res;
+}
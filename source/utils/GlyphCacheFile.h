@@ -0,0 +1,22 @@
+#pragma once
+
+#include "GlyphCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * FNV-1a hash, used to identify the font a cache file was made for and to checksum its content.
+ */
+uint32_t HashGlyphData(const void *data, size_t size, uint32_t hash = 0x811C9DC5);
+
+/**
+ * Loads the glyphs of a cache file into the cache with a single read. Files that were written for another key,
+ * by another version or that are damaged are ignored.
+ */
+bool LoadGlyphCacheFile(std::string_view path, uint32_t key, GlyphCache &cache);
+
+/**
+ * Writes all glyphs of the cache into a file that LoadGlyphCacheFile accepts for the same key.
+ */
+bool SaveGlyphCacheFile(std::string_view path, uint32_t key, const GlyphCache &cache);
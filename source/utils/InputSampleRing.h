@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free ring buffer for exactly one producer and one consumer, e.g. a sampling callback and the menu loop.
+ * Neither side ever blocks; when the consumer falls behind, new samples are dropped and counted.
+ */
+template<typename T, uint32_t Capacity>
+class InputSampleRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * Producer side. Returns false if the ring is full.
+     */
+    bool push(const T &sample) {
+        uint32_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) >= Capacity) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        mSamples[head & (Capacity - 1)] = sample;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Returns false if the ring is empty.
+     */
+    bool pop(T &sample) {
+        uint32_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mHead.load(std::memory_order_acquire)) {
+            return false;
+        }
+        sample = mSamples[tail & (Capacity - 1)];
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Calls func for the queued samples, oldest first, and returns how many were taken.
+     * When func returns false the sample stays in the ring and draining stops.
+     */
+    template<typename Func>
+    uint32_t drain(Func func) {
+        uint32_t count = 0;
+        uint32_t tail  = mTail.load(std::memory_order_relaxed);
+        uint32_t head  = mHead.load(std::memory_order_acquire);
+        while (tail != head && func(static_cast<const T &>(mSamples[tail & (Capacity - 1)]))) {
+            tail++;
+            count++;
+        }
+        mTail.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Number of samples ever pushed, which lets the consumer notice that the producer is running.
+     */
+    [[nodiscard]] uint32_t getPushed() const { return mHead.load(std::memory_order_acquire); }
+
+    [[nodiscard]] uint32_t getDropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+    T mSamples[Capacity];
+    std::atomic<uint32_t> mHead    = 0;
+    std::atomic<uint32_t> mTail    = 0;
+    std::atomic<uint32_t> mDropped = 0;
+};
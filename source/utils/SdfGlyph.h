@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+// Glyphs are rendered once as distance fields at the reference size and resampled for every other size.
+#define SDF_REFERENCE_SIZE 36
+#define SDF_PADDING        4
+// magnifying further visibly rounds the corners, bigger glyphs are rasterized directly
+#define SDF_MAX_SIZE       (SDF_REFERENCE_SIZE * 2)
+
+/**
+ * Bilinear sample of a distance field, coordinates are in pixels with the pixel centers at .5
+ */
+inline float SampleSdf(const uint8_t *sdf, int32_t width, int32_t height, float x, float y) {
+    x -= 0.5f;
+    y -= 0.5f;
+    x = x < 0.0f ? 0.0f : (x > (float) (width - 1) ? (float) (width - 1) : x);
+    y = y < 0.0f ? 0.0f : (y > (float) (height - 1) ? (float) (height - 1) : y);
+
+    auto x0  = (int32_t) x;
+    auto y0  = (int32_t) y;
+    auto x1  = x0 + 1 < width ? x0 + 1 : x0;
+    auto y1  = y0 + 1 < height ? y0 + 1 : y0;
+    float fx = x - (float) x0;
+    float fy = y - (float) y0;
+
+    const uint8_t *row0 = sdf + y0 * width;
+    const uint8_t *row1 = sdf + y1 * width;
+    float top           = (float) row0[x0] + ((float) row0[x1] - (float) row0[x0]) * fx;
+    float bottom        = (float) row1[x0] + ((float) row1[x1] - (float) row1[x0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+/**
+ * Fills the coverage of a glyph box from a distance field rendered at SDF_REFERENCE_SIZE with SDF_PADDING.
+ * Each pixel is covered by how far its center lies inside the outline, clamped to half a pixel.
+ *
+ * left and top are the edges of both glyph boxes relative to the pen in their own size, without the padding.
+ * scale is the number of reference pixels per target pixel.
+ */
+inline void ResampleSdf(const uint8_t *sdf, int32_t sdfWidth, int32_t sdfHeight, float sdfLeft, float sdfTop,
+                        uint8_t *dst, int32_t width, int32_t height, float left, float top, float scale) {
+    for (int32_t j = 0; j < height; j++) {
+        float sy = ((float) j + 0.5f - top) * scale + sdfTop + SDF_PADDING;
+        for (int32_t i = 0; i < width; i++) {
+            float sx    = (left + (float) i + 0.5f) * scale - sdfLeft + SDF_PADDING;
+            float value = SampleSdf(sdf, sdfWidth, sdfHeight, sx, sy) - 128.0f;
+            // distance in target pixels, positive inside
+            float distance = value / (value >= 0.0f ? 127.0f : 128.0f) * SDF_PADDING / scale;
+            float coverage = distance + 0.5f;
+            coverage       = coverage < 0.0f ? 0.0f : (coverage > 1.0f ? 1.0f : coverage);
+            dst[i]         = (uint8_t) (coverage * 255.0f + 0.5f);
+        }
+        dst += width;
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Fills map[0..sourceSize] for nearest-neighbour upscaling, source pixel i covers the target pixels [map[i], map[i + 1]).
+ * Every target pixel belongs to exactly one source pixel, map[sourceSize] is targetSize.
+ */
+inline void BuildUpscaleMap(uint16_t *map, uint32_t sourceSize, uint32_t targetSize) {
+    for (uint32_t i = 0; i <= sourceSize; i++) {
+        map[i] = i * targetSize / sourceSize;
+    }
+}
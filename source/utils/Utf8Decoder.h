@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Iterates the codepoints of a UTF-8 string in place, without allocating and independent of the locale.
+ * Invalid, overlong or truncated sequences decode to U+FFFD and only consume their first byte.
+ */
+class Utf8Decoder {
+public:
+    explicit Utf8Decoder(std::string_view str) : mStr(str) {}
+
+    bool next(uint32_t &codepoint) {
+        if (mPos >= mStr.size()) {
+            return false;
+        }
+        auto lead = (uint8_t) mStr[mPos++];
+        if (lead < 0x80) {
+            codepoint = lead;
+            return true;
+        }
+
+        uint32_t length;
+        uint32_t min;
+        if ((lead & 0xE0) == 0xC0) {
+            length    = 1;
+            min       = 0x80;
+            codepoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length    = 2;
+            min       = 0x800;
+            codepoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length    = 3;
+            min       = 0x10000;
+            codepoint = lead & 0x07;
+        } else {
+            codepoint = REPLACEMENT_CHARACTER;
+            return true;
+        }
+
+        if (mStr.size() - mPos < length) {
+            codepoint = REPLACEMENT_CHARACTER;
+            return true;
+        }
+        for (uint32_t i = 0; i < length; i++) {
+            auto cont = (uint8_t) mStr[mPos + i];
+            if ((cont & 0xC0) != 0x80) {
+                codepoint = REPLACEMENT_CHARACTER;
+                return true;
+            }
+            codepoint = (codepoint << 6) | (cont & 0x3F);
+        }
+        if (codepoint < min || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+            codepoint = REPLACEMENT_CHARACTER;
+            return true;
+        }
+        mPos += length;
+        return true;
+    }
+
+    static constexpr uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+private:
+    std::string_view mStr;
+    size_t mPos = 0;
+};
@@ -0,0 +1,144 @@
+#include "TestUtils.h"
+#include "host/MemoryScreen.h"
+#include <vector>
+
+/**
+ * Checks drawBitmap against a reference that samples the BMP pixel by pixel and draws it with drawPixel, for
+ * bottom-up and top-down rows, padded rows, scaling both ways and clipping, then measures its throughput.
+ */
+
+static void writeLE32(uint8_t *data, uint32_t value) {
+    data[0] = value;
+    data[1] = value >> 8;
+    data[2] = value >> 16;
+    data[3] = value >> 24;
+}
+
+// a 24 bit BMP with a pattern that differs in every pixel, rows are top-down if topDown is set
+static std::vector<uint8_t> makeBitmap(uint32_t width, uint32_t height, bool topDown, uint32_t bpp = 24) {
+    uint32_t stride = (width * 3 + 3) & ~3;
+    std::vector<uint8_t> bmp(54 + stride * height);
+    bmp[0] = 'B';
+    bmp[1] = 'M';
+    writeLE32(&bmp[0x02], bmp.size());
+    writeLE32(&bmp[0x0A], 54);
+    writeLE32(&bmp[0x0E], 40);
+    writeLE32(&bmp[0x12], width);
+    writeLE32(&bmp[0x16], topDown ? -(int32_t) height : (int32_t) height);
+    bmp[0x1A] = 1;
+    bmp[0x1C] = bpp;
+    for (uint32_t row = 0; row < height; row++) {
+        // the image row this BMP row holds
+        uint32_t y   = topDown ? row : height - 1 - row;
+        uint8_t *bgr = &bmp[54 + row * stride];
+        for (uint32_t x = 0; x < width; x++, bgr += 3) {
+            bgr[0] = (uint8_t) (x * 7 + y);
+            bgr[1] = (uint8_t) (y * 13);
+            bgr[2] = (uint8_t) (x * 29 + y * 3);
+        }
+        // garbage in the row padding must never show up
+        for (uint32_t i = width * 3; i < stride; i++) {
+            bgr[i - width * 3] = 0xA5;
+        }
+    }
+    return bmp;
+}
+
+// the image pixel x,y of makeBitmap, independent of the row order
+static Color bitmapPixel(uint32_t x, uint32_t y) {
+    return Color((uint8_t) (x * 29 + y * 3), (uint8_t) (y * 13), (uint8_t) (x * 7 + y), 0xFF);
+}
+
+static void drawBitmapPerPixel(uint32_t x, uint32_t y, uint32_t targetWidth, uint32_t targetHeight, uint32_t width, uint32_t height) {
+    for (uint32_t yy = 0; yy < targetHeight; yy++) {
+        for (uint32_t xx = 0; xx < targetWidth; xx++) {
+            DrawUtils::drawPixel(x + xx, y + yy, bitmapPixel(xx * width / targetWidth, yy * height / targetHeight));
+        }
+    }
+}
+
+struct BitmapCase {
+    uint32_t width; // of the BMP
+    uint32_t height;
+    Rect target; // x1/y1 hold width and height, they may reach past the screen
+    Rect clip;
+};
+
+static void testMatchesReference(MemoryScreen &screen) {
+    const Rect fullScreen(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    const BitmapCase cases[] = {
+            {64, 64, {10, 10, 64, 64}, fullScreen},
+            {13, 7, {100, 50, 64, 64}, fullScreen},
+            {13, 7, {0, 0, 13, 7}, fullScreen},
+            {101, 50, {200, 100, 37, 23}, fullScreen},
+            {128, 128, {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}, fullScreen},
+            {31, 17, {SCREEN_WIDTH - 20, SCREEN_HEIGHT - 10, 64, 64}, fullScreen},
+            {31, 17, {50, 50, 300, 200}, Rect(120, 90, 77, 1)},
+            {31, 17, {50, 50, 300, 200}, Rect(349, 0, 100, 480)},
+            {2, 1, {0, 0, 854, 3}, Rect(0, 1, SCREEN_WIDTH, 2)},
+    };
+
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        for (const auto &c : cases) {
+            for (bool topDown : {false, true}) {
+                auto bmp   = makeBitmap(c.width, c.height, topDown);
+                uint32_t x = c.target.x0, y = c.target.y0, w = c.target.x1 - c.target.x0, h = c.target.y1 - c.target.y0;
+                auto draw  = [&](bool perPixel) {
+                    return screen.hashFrame([&]() {
+                        DrawUtils::setClipRect(c.clip);
+                        if (perPixel) {
+                            drawBitmapPerPixel(x, y, w, h, c.width, c.height);
+                        } else {
+                            DrawUtils::drawBitmap(x, y, w, h, bmp.data());
+                        }
+                        DrawUtils::resetClipRect();
+                    });
+                };
+                uint32_t expected = draw(true);
+                uint32_t actual   = draw(false);
+                CHECK(expected == actual, "%s %s %ux%u drawn at %u,%u as %ux%u: %08X, reference %08X", canvas ? "canvas" : "direct",
+                      topDown ? "top-down" : "bottom-up", c.width, c.height, x, y, w, h, actual, expected);
+            }
+        }
+    }
+    DrawUtils::setCanvasEnabled(true);
+
+    // bitmaps it can't draw leave the frame alone
+    uint32_t empty = screen.hashFrame([]() {});
+    auto bmp32     = makeBitmap(16, 16, false, 32);
+    auto bmp24     = makeBitmap(16, 16, false);
+    bmp24[0]       = 'X';
+    CHECK(screen.hashFrame([&]() { DrawUtils::drawBitmap(0, 0, 16, 16, bmp32.data()); }) == empty, "drew a 32 bit bitmap");
+    CHECK(screen.hashFrame([&]() { DrawUtils::drawBitmap(0, 0, 16, 16, bmp24.data()); }) == empty, "drew a bitmap without the BM header");
+}
+
+static void benchmarkBitmaps() {
+    const uint32_t sizes[][2] = {{64, 64}, {128, 128}, {SCREEN_WIDTH, SCREEN_HEIGHT}};
+    auto bmp                  = makeBitmap(128, 128, false);
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        for (const auto &size : sizes) {
+            uint32_t w = size[0], h = size[1];
+            uint32_t rounds = w * h > 128 * 128 ? 20 : 500;
+            DrawUtils::beginDraw();
+            double perPixelUs = MemoryScreen::timeUs(rounds, [&]() { drawBitmapPerPixel(0, 0, w, h, 128, 128); });
+            double blitUs     = MemoryScreen::timeUs(rounds, [&]() { DrawUtils::drawBitmap(0, 0, w, h, bmp.data()); });
+            DrawUtils::endDraw();
+            printf("BitmapBlitTest: %s 128x128 to %3ux%3u: %7.1f us, %6.1f Mpixel/s (per pixel %7.1f us, %.1fx)\n", canvas ? "canvas" : "direct", w, h, blitUs,
+                   w * h / blitUs, perPixelUs, perPixelUs / blitUs);
+        }
+    }
+    DrawUtils::setCanvasEnabled(true);
+}
+
+int main() {
+    MemoryScreen screen;
+    CHECK(screen.isValid(), "failed to set up the screen, is fonts/Lato-Regular.ttf missing?");
+    if (!screen.isValid()) {
+        return testResult("BitmapBlitTest");
+    }
+    testMatchesReference(screen);
+    benchmarkBitmaps();
+    return testResult("BitmapBlitTest");
+}
@@ -0,0 +1,107 @@
+#include "TestUtils.h"
+#include "utils/Blend.h"
+#include <cmath>
+
+/**
+ * Compares the fixed point kernels with blending in float for every combination of alpha, source and destination
+ * channel. They must stay within one step of the float result.
+ */
+static float blendFloat(float src, float dst, float alpha) {
+    return (src * alpha + dst * (255.0f - alpha)) / 255.0f;
+}
+
+static bool within1(uint32_t value, float expected) {
+    return fabsf((float) value - expected) <= 1.0f;
+}
+
+static void checkDiv255() {
+    for (uint32_t a = 0; a < 256; a++) {
+        for (uint32_t b = 0; b < 256; b++) {
+            auto expected = (uint32_t) lroundf((float) (a * b) / 255.0f);
+            CHECK(Div255(a * b) == expected, "Div255(%u * %u) is %u, expected %u", a, b, Div255(a * b), expected);
+        }
+    }
+}
+
+static void checkFillSpan() {
+    uint32_t dst[256];
+    for (uint32_t alpha = 0; alpha < 256; alpha++) {
+        for (uint32_t src = 0; src < 256; src++) {
+            // every destination value at once, the other channels check that they don't bleed into each other
+            for (uint32_t d = 0; d < 256; d++) {
+                dst[d] = Color(d, 255 - d, d, 0xFF).color;
+            }
+            FillSpan(dst, 256, Color(src, src, 255 - src, alpha));
+            for (uint32_t d = 0; d < 256; d++) {
+                Color out(dst[d]);
+                CHECK(within1(out.r, blendFloat(src, d, alpha)), "FillSpan r: src %u dst %u alpha %u gave %u", src, d, alpha, out.r);
+                CHECK(within1(out.g, blendFloat(src, 255 - d, alpha)), "FillSpan g: src %u dst %u alpha %u gave %u", src, 255 - d, alpha, out.g);
+                CHECK(within1(out.b, blendFloat(255 - src, d, alpha)), "FillSpan b: src %u dst %u alpha %u gave %u", 255 - src, d, alpha, out.b);
+                CHECK(out.a == 0xFF, "FillSpan changed the destination alpha to %u", out.a);
+            }
+        }
+    }
+}
+
+static void checkBlendColor() {
+    for (uint32_t alpha = 1; alpha < 255; alpha++) {
+        for (uint32_t src = 0; src < 256; src++) {
+            for (uint32_t d = 0; d < 256; d++) {
+                Color out(BlendColor(Color(d, d, d, 0xFF).color, Color(src, 0, 255, 0xFF), alpha));
+                CHECK(within1(out.r, blendFloat(src, d, alpha)), "BlendColor r: src %u dst %u alpha %u gave %u", src, d, alpha, out.r);
+                CHECK(within1(out.g, blendFloat(0, d, alpha)), "BlendColor g: dst %u alpha %u gave %u", d, alpha, out.g);
+                CHECK(within1(out.b, blendFloat(255, d, alpha)), "BlendColor b: dst %u alpha %u gave %u", d, alpha, out.b);
+            }
+        }
+    }
+}
+
+// images are premultiplied when they're decoded, the result is compared with blending the straight color
+static void checkBlendPremultiplied() {
+    for (uint32_t alpha = 1; alpha < 255; alpha++) {
+        for (uint32_t src = 0; src < 256; src++) {
+            uint32_t premultiplied = Div255(src * alpha);
+            for (uint32_t d = 0; d < 256; d++) {
+                Color out(BlendPremultiplied(Color(d, d, d, 0xFF).color, Color(premultiplied, premultiplied, premultiplied, alpha)));
+                CHECK(within1(out.r, blendFloat(src, d, alpha)), "BlendPremultiplied: src %u dst %u alpha %u gave %u", src, d, alpha, out.r);
+            }
+        }
+    }
+}
+
+// the glyph coverage and the alpha of the font color multiply
+static void checkBlendCoverageRun() {
+    uint8_t alphaTable[256];
+    uint8_t coverage[256];
+    uint32_t dst[256];
+    for (uint32_t i = 0; i < 256; i++) {
+        coverage[i] = i;
+    }
+    for (uint32_t fontAlpha = 0; fontAlpha < 256; fontAlpha++) {
+        BuildCoverageAlphaTable(alphaTable, fontAlpha);
+        for (uint32_t src = 0; src < 256; src += 15) {
+            Color col(src, src, src, fontAlpha);
+            uint32_t opaque = Color(src, src, src, 0xFF).color;
+            for (uint32_t d = 0; d < 256; d++) {
+                for (uint32_t i = 0; i < 256; i++) {
+                    dst[i] = Color(d, d, d, 0xFF).color;
+                }
+                BlendCoverageRun(dst, coverage, 256, alphaTable, col, opaque);
+                for (uint32_t c = 0; c < 256; c++) {
+                    Color out(dst[c]);
+                    float expected = blendFloat(src, d, (float) fontAlpha * (float) c / 255.0f);
+                    CHECK(within1(out.r, expected), "BlendCoverageRun: src %u dst %u alpha %u coverage %u gave %u, expected %.2f", src, d, fontAlpha, c, out.r, expected);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    checkDiv255();
+    checkFillSpan();
+    checkBlendColor();
+    checkBlendPremultiplied();
+    checkBlendCoverageRun();
+    return testResult("BlendTest");
+}
@@ -0,0 +1,139 @@
+#include "TestUtils.h"
+#include "utils/ButtonLayouts.h"
+#include "utils/ButtonRemap.h"
+
+// The remaps InputUtils used before the tables, kept as the reference.
+
+static uint32_t remapWiiMoteButtons(uint32_t buttons) {
+    uint32_t convButtons = 0;
+
+    if (buttons & WPAD_BUTTON_LEFT)
+        convButtons |= VPAD_BUTTON_LEFT;
+
+    if (buttons & WPAD_BUTTON_RIGHT)
+        convButtons |= VPAD_BUTTON_RIGHT;
+
+    if (buttons & WPAD_BUTTON_DOWN)
+        convButtons |= VPAD_BUTTON_DOWN;
+
+    if (buttons & WPAD_BUTTON_UP)
+        convButtons |= VPAD_BUTTON_UP;
+
+    if (buttons & WPAD_BUTTON_PLUS)
+        convButtons |= VPAD_BUTTON_PLUS;
+
+    if (buttons & WPAD_BUTTON_2)
+        convButtons |= VPAD_BUTTON_Y;
+
+    if (buttons & WPAD_BUTTON_1)
+        convButtons |= VPAD_BUTTON_X;
+
+    if (buttons & WPAD_BUTTON_B)
+        convButtons |= VPAD_BUTTON_B;
+
+    if (buttons & WPAD_BUTTON_A)
+        convButtons |= VPAD_BUTTON_A;
+
+    if (buttons & WPAD_BUTTON_MINUS)
+        convButtons |= VPAD_BUTTON_MINUS;
+
+    if (buttons & WPAD_BUTTON_HOME)
+        convButtons |= VPAD_BUTTON_HOME;
+
+    return convButtons;
+}
+
+static uint32_t remapClassicButtons(uint32_t buttons) {
+    uint32_t convButtons = 0;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_LEFT)
+        convButtons |= VPAD_BUTTON_LEFT;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_RIGHT)
+        convButtons |= VPAD_BUTTON_RIGHT;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_DOWN)
+        convButtons |= VPAD_BUTTON_DOWN;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_UP)
+        convButtons |= VPAD_BUTTON_UP;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_PLUS)
+        convButtons |= VPAD_BUTTON_PLUS;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_X)
+        convButtons |= VPAD_BUTTON_X;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_Y)
+        convButtons |= VPAD_BUTTON_Y;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_B)
+        convButtons |= VPAD_BUTTON_B;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_A)
+        convButtons |= VPAD_BUTTON_A;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_MINUS)
+        convButtons |= VPAD_BUTTON_MINUS;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_HOME)
+        convButtons |= VPAD_BUTTON_HOME;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_ZR)
+        convButtons |= VPAD_BUTTON_ZR;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_ZL)
+        convButtons |= VPAD_BUTTON_ZL;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_R)
+        convButtons |= VPAD_BUTTON_R;
+
+    if (buttons & WPAD_CLASSIC_BUTTON_L)
+        convButtons |= VPAD_BUTTON_L;
+
+    return convButtons;
+}
+
+static void checkLayout(const char *name, const ButtonRemap &remap, uint32_t (*reference)(uint32_t)) {
+    uint32_t mismatches = 0;
+    for (uint32_t buttons = 0; buttons <= 0xFFFF; buttons++) {
+        if (remap.map(buttons) != reference(buttons)) {
+            if (mismatches++ < 8) {
+                CHECK(false, "%s: 0x%04X maps to 0x%05X, expected 0x%05X", name, buttons, remap.map(buttons), reference(buttons));
+            }
+        }
+    }
+    CHECK(mismatches == 0, "%s: %u of 65536 masks differ", name, mismatches);
+}
+
+int main() {
+    static constexpr ButtonRemap wiimote(WIIMOTE_BINDINGS);
+    static constexpr ButtonRemap classic(CLASSIC_BINDINGS);
+    static constexpr ButtonRemap pro(PRO_BINDINGS);
+
+    checkLayout("wiimote", wiimote, remapWiiMoteButtons);
+    checkLayout("classic", classic, remapClassicButtons);
+    // the Pro Controller was read through the classic status, which uses the same bits
+    checkLayout("pro", pro, remapClassicButtons);
+
+    // only the Pro Controller stick buttons are above the lower 16 bits
+    CHECK(pro.map(WPAD_PRO_BUTTON_STICK_L | WPAD_PRO_BUTTON_STICK_R) == (VPAD_BUTTON_STICK_L | VPAD_BUTTON_STICK_R), "pro: stick buttons map to 0x%05X",
+          pro.map(WPAD_PRO_BUTTON_STICK_L | WPAD_PRO_BUTTON_STICK_R));
+
+    // rebinding only changes the rebound button
+    ButtonRemap rebound = wiimote;
+    rebound.rebind(WPAD_BUTTON_2, VPAD_BUTTON_A | VPAD_BUTTON_B);
+    rebound.rebind(WPAD_BUTTON_HOME, 0);
+    for (uint32_t buttons = 0; buttons <= 0xFFFF; buttons++) {
+        uint32_t expected = remapWiiMoteButtons(buttons & ~(WPAD_BUTTON_2 | WPAD_BUTTON_HOME));
+        if (buttons & WPAD_BUTTON_2) {
+            expected |= VPAD_BUTTON_A | VPAD_BUTTON_B;
+        }
+        if (rebound.map(buttons) != expected) {
+            CHECK(false, "rebound: 0x%04X maps to 0x%05X, expected 0x%05X", buttons, rebound.map(buttons), expected);
+            break;
+        }
+    }
+
+    return testResult("ButtonRemapTest");
+}
@@ -0,0 +1,63 @@
+#include "TestUtils.h"
+#include "schrift.h"
+#include <chrono>
+
+/**
+ * Checks that the direct cmap table of sft_loadmem_ex(SFT_DIRECT_CMAP) returns the same glyphs as the cmap search
+ * for every codepoint of the BMP and the first supplementary plane, and compares their lookup throughput on the
+ * characters the menus draw.
+ */
+static double lookupsPerMicrosecond(const SFT &sft, const char *text, uint32_t rounds, SFT_Glyph &sum) {
+    auto start     = std::chrono::steady_clock::now();
+    uint32_t count = 0;
+    for (uint32_t round = 0; round < rounds; round++) {
+        for (const char *c = text; *c; c++) {
+            SFT_Glyph gid = 0;
+            sft_lookup(&sft, (uint8_t) *c, &gid);
+            sum += gid;
+            count++;
+        }
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return count / us;
+}
+
+int main() {
+    std::vector<uint8_t> font = readFile("fonts/Lato-Regular.ttf");
+    CHECK(!font.empty(), "fonts/Lato-Regular.ttf missing");
+    if (font.empty()) {
+        return testResult("CmapLookupTest");
+    }
+    SFT search = {};
+    SFT direct = {};
+    search.font = sft_loadmem(font.data(), font.size());
+    direct.font = sft_loadmem_ex(font.data(), font.size(), SFT_DIRECT_CMAP);
+    CHECK(search.font && direct.font, "failed to load the font");
+    if (!search.font || !direct.font) {
+        return testResult("CmapLookupTest");
+    }
+
+    for (uint32_t codepoint = 0; codepoint < 0x20000; codepoint++) {
+        SFT_Glyph expected = 0, actual = 0;
+        int expectedRes = sft_lookup(&search, codepoint, &expected);
+        int actualRes   = sft_lookup(&direct, codepoint, &actual);
+        CHECK(expectedRes == actualRes && expected == actual, "U+%04X: glyph %u (%d), direct %u (%d)", codepoint, (uint32_t) expected, expectedRes,
+              (uint32_t) actual, actualRes);
+    }
+
+    // ASCII only, the lookups take single bytes
+    const char *text = "Wii U Menu Homebrew Launcher vWii System Menu vWii Homebrew Channel Select your Account 1/2 "
+                       "Press A to boot the selected title. Updates blocked! Hold + and - to restore Update folder";
+    SFT_Glyph sum   = 0;
+    // warm up the caches of both
+    lookupsPerMicrosecond(search, text, 100, sum);
+    lookupsPerMicrosecond(direct, text, 100, sum);
+    double searchRate = lookupsPerMicrosecond(search, text, 20000, sum);
+    double directRate = lookupsPerMicrosecond(direct, text, 20000, sum);
+    printf("CmapLookupTest: cmap search %.1f lookups/us, direct table %.1f lookups/us (%.1fx)\n", searchRate, directRate, directRate / searchRate);
+    CHECK(sum != 0, "no glyph found");
+
+    sft_freefont(search.font);
+    sft_freefont(direct.font);
+    return testResult("CmapLookupTest");
+}
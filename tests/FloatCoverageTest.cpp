@@ -0,0 +1,92 @@
+#include "TestUtils.h"
+#include "host/SchriftFloat.h"
+#include "schrift.h"
+#include <chrono>
+#include <cstdlib>
+#include <set>
+
+/**
+ * Golden test of `make SFT_FLOAT=1`: every glyph of the test font is rasterized in every size from 10 to 100 with
+ * the default double precision build, which is the reference, and with the single precision build. Both have to
+ * produce the same metrics and their coverage may differ by at most 1/255.
+ */
+int main() {
+    std::vector<uint8_t> font = readFile("fonts/Lato-Regular.ttf");
+    CHECK(!font.empty(), "fonts/Lato-Regular.ttf missing");
+    if (font.empty()) {
+        return testResult("FloatCoverageTest");
+    }
+    CHECK(sft_uses_float() == 0 && sftf_uses_float() == 1, "the builds don't use the expected precision");
+
+    SFT sftDouble   = {};
+    sftDouble.flags = SFT_DOWNWARD_Y;
+    sftDouble.font  = sft_loadmem(font.data(), font.size());
+    SFT sftFloat    = sftDouble;
+    sftFloat.font   = sftf_loadmem(font.data(), font.size());
+    CHECK(sftDouble.font && sftFloat.font, "failed to load the font");
+    if (!sftDouble.font || !sftFloat.font) {
+        return testResult("FloatCoverageTest");
+    }
+
+    // every glyph that is mapped to a character
+    std::set<SFT_Glyph> glyphs;
+    for (uint32_t codepoint = 0; codepoint <= 0xFFFF; codepoint++) {
+        SFT_Glyph gid;
+        if (sft_lookup(&sftDouble, codepoint, &gid) >= 0 && gid != 0) {
+            glyphs.insert(gid);
+        }
+    }
+
+    std::chrono::steady_clock::duration doubleTime{}, floatTime{};
+    uint64_t pixels = 0, differentPixels = 0;
+    uint32_t rendered = 0, maxDiff = 0;
+    std::vector<uint8_t> expected, actual;
+    for (uint32_t size = 10; size <= 100; size++) {
+        sftDouble.xScale = sftDouble.yScale = size;
+        sftFloat.xScale = sftFloat.yScale = size;
+        for (SFT_Glyph gid : glyphs) {
+            SFT_GMetrics mtxDouble, mtxFloat;
+            if (sft_gmetrics(&sftDouble, gid, &mtxDouble) < 0 || sftf_gmetrics(&sftFloat, gid, &mtxFloat) < 0) {
+                CHECK(false, "glyph %u size %u: no metrics", (uint32_t) gid, size);
+                continue;
+            }
+            CHECK(mtxDouble.minWidth == mtxFloat.minWidth && mtxDouble.minHeight == mtxFloat.minHeight && mtxDouble.yOffset == mtxFloat.yOffset,
+                  "glyph %u size %u: box %dx%d+%d, float %dx%d+%d", (uint32_t) gid, size, mtxDouble.minWidth, mtxDouble.minHeight, mtxDouble.yOffset,
+                  mtxFloat.minWidth, mtxFloat.minHeight, mtxFloat.yOffset);
+            if (mtxDouble.minWidth != mtxFloat.minWidth || mtxDouble.minHeight != mtxFloat.minHeight || mtxDouble.minWidth == 0) {
+                continue;
+            }
+            int32_t width  = (mtxDouble.minWidth + 3) & ~3;
+            int32_t height = mtxDouble.minHeight;
+            expected.assign(width * height, 0);
+            actual.assign(width * height, 0);
+
+            auto start = std::chrono::steady_clock::now();
+            CHECK(sft_render(&sftDouble, gid, {expected.data(), width, height}) >= 0, "glyph %u size %u: render failed", (uint32_t) gid, size);
+            auto mid = std::chrono::steady_clock::now();
+            CHECK(sftf_render(&sftFloat, gid, {actual.data(), width, height}) >= 0, "glyph %u size %u: float render failed", (uint32_t) gid, size);
+            floatTime += std::chrono::steady_clock::now() - mid;
+            doubleTime += mid - start;
+            rendered++;
+
+            for (size_t i = 0; i < expected.size(); i++) {
+                auto diff = (uint32_t) abs((int32_t) expected[i] - (int32_t) actual[i]);
+                if (diff != 0) {
+                    differentPixels++;
+                    maxDiff = diff > maxDiff ? diff : maxDiff;
+                }
+                CHECK(diff <= 1, "glyph %u size %u pixel %zu: coverage %u, float %u", (uint32_t) gid, size, i, expected[i], actual[i]);
+            }
+            pixels += expected.size();
+        }
+    }
+
+    printf("FloatCoverageTest: %u glyph renders, %zu glyphs in sizes 10-100\n", rendered, glyphs.size());
+    printf("FloatCoverageTest: %llu of %llu pixels differ, by at most %u/255\n", (unsigned long long) differentPixels, (unsigned long long) pixels, maxDiff);
+    printf("FloatCoverageTest: double %.1f ms, float %.1f ms\n", std::chrono::duration<double, std::milli>(doubleTime).count(),
+           std::chrono::duration<double, std::milli>(floatTime).count());
+
+    sft_freefont(sftDouble.font);
+    sftf_freefont(sftFloat.font);
+    return testResult("FloatCoverageTest");
+}
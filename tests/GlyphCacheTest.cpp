@@ -0,0 +1,160 @@
+#include "DisplayList.h"
+#include "MenuUtils.h"
+#include "TestUtils.h"
+#include "host/MemoryScreen.h"
+#include "utils/GlyphCache.h"
+#include <cstring>
+
+/**
+ * Checks the LRU eviction and the compaction of GlyphCache, then renders the Boot Selector 1000 times with and
+ * without the glyph cache of DrawUtils.
+ */
+
+// MenuUtils.cpp doesn't export them, the menus only call them itself
+void drawMenuScreenChrome();
+void drawMenuScreen(DisplayList &displayList, const std::map<uint32_t, std::string> &menu, uint32_t selectedIndex, uint32_t autobootIndex, bool updatesBlocked);
+
+// inserts a glyph whose pixels all hold the low byte of its codepoint
+static bool insertGlyph(GlyphCache &cache, uint32_t codepoint, uint32_t size) {
+    CachedGlyph *glyph = cache.insert(codepoint, 20, size);
+    if (!glyph) {
+        return false;
+    }
+    glyph->width  = (int32_t) size;
+    glyph->height = 1;
+    memset(glyph->pixels, (uint8_t) codepoint, size);
+    return true;
+}
+
+static bool hasPixelsOf(GlyphCache &cache, uint32_t codepoint) {
+    const CachedGlyph *glyph = cache.find(codepoint, 20);
+    if (!glyph) {
+        return false;
+    }
+    for (int32_t i = 0; i < glyph->width; i++) {
+        if (glyph->pixels[i] != (uint8_t) codepoint) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testLruEviction() {
+    // room for 8 glyphs of 128 bytes
+    GlyphCache cache(1024, 16);
+    CHECK(cache.isValid(), "failed to allocate the cache");
+    for (uint32_t c = 'a'; c < 'a' + 8; c++) {
+        CHECK(insertGlyph(cache, c, 128), "failed to insert %c", c);
+    }
+    CHECK(cache.getEvictions() == 0, "%u evictions before the arena was full", cache.getEvictions());
+
+    // use the three oldest, so b, c and d are now the least recently used
+    for (uint32_t c : {'a', 'e', 'f'}) {
+        CHECK(cache.find(c, 20) != nullptr, "%c missing", c);
+    }
+    CHECK(insertGlyph(cache, 'i', 128), "failed to insert i");
+    CHECK(insertGlyph(cache, 'j', 256), "failed to insert j");
+    CHECK(cache.getEvictions() == 3, "%u evictions, expected 3", cache.getEvictions());
+    for (uint32_t c : {'b', 'c', 'd'}) {
+        CHECK(!cache.contains(c, 20), "%c should have been evicted", c);
+    }
+    for (uint32_t c : {'a', 'e', 'f', 'g', 'h', 'i', 'j'}) {
+        CHECK(hasPixelsOf(cache, c), "%c missing or damaged", c);
+    }
+
+    // the entry table runs out before the arena does
+    GlyphCache entries(1024, 4);
+    for (uint32_t c = 'a'; c < 'a' + 6; c++) {
+        CHECK(insertGlyph(entries, c, 16), "failed to insert %c", c);
+    }
+    CHECK(entries.getEvictions() == 2 && !entries.contains('a', 20) && !entries.contains('b', 20) && entries.contains('f', 20),
+          "%u evictions, expected a and b to be evicted", entries.getEvictions());
+
+    CHECK(cache.insert('z', 20, 2048) == nullptr, "a glyph bigger than the arena got inserted");
+    uint32_t hits = cache.getHits(), misses = cache.getMisses();
+    cache.find('a', 20);
+    cache.find('b', 20);
+    CHECK(cache.getHits() == hits + 1 && cache.getMisses() == misses + 1, "hits %u -> %u, misses %u -> %u", hits, cache.getHits(), misses, cache.getMisses());
+}
+
+static void testCompaction() {
+    GlyphCache cache(1024, 16);
+    for (uint32_t c = 'a'; c < 'a' + 8; c++) {
+        CHECK(insertGlyph(cache, c, 128), "failed to insert %c", c);
+    }
+    // free two holes in the middle, neither is big enough for 256 bytes and the end of the arena is full
+    cache.remove('b', 20);
+    cache.remove('e', 20);
+    CHECK(cache.getUsedBytes() == 768, "%u bytes used", cache.getUsedBytes());
+    CHECK(insertGlyph(cache, 'x', 256), "failed to insert x");
+    CHECK(cache.getEvictions() == 0, "%u evictions, the arena only needed compacting", cache.getEvictions());
+    CHECK(cache.getUsedBytes() == 1024, "%u bytes used", cache.getUsedBytes());
+    for (uint32_t c : {'a', 'c', 'd', 'f', 'g', 'h', 'x'}) {
+        CHECK(hasPixelsOf(cache, c), "%c missing or damaged after compacting", c);
+    }
+
+    // the bitmaps stay 4 byte aligned and are packed without gaps after compacting
+    cache.remove('a', 20);
+    CHECK(insertGlyph(cache, 'y', 127), "failed to insert y");
+    uint32_t bytes = 0;
+    cache.forEach([&bytes](const CachedGlyph &glyph) {
+        CHECK(((uintptr_t) glyph.pixels & 3) == 0, "glyph %c isn't aligned", glyph.codepoint);
+        bytes += (glyph.width + 3) & ~3;
+    });
+    CHECK(bytes == cache.getUsedBytes(), "glyphs hold %u bytes, %u bytes used", bytes, cache.getUsedBytes());
+    for (uint32_t c : {'c', 'd', 'f', 'g', 'h', 'x', 'y'}) {
+        CHECK(hasPixelsOf(cache, c), "%c missing or damaged after compacting", c);
+    }
+}
+
+static const std::map<uint32_t, std::string> menu = {
+        {BOOT_OPTION_WII_U_MENU, "Wii U Menu"},
+        {BOOT_OPTION_HOMEBREW_LAUNCHER, "Homebrew Launcher"},
+        {BOOT_OPTION_VWII_SYSTEM_MENU, "vWii System Menu"},
+        {BOOT_OPTION_VWII_HOMEBREW_CHANNEL, "vWii Homebrew Channel"},
+};
+
+// a whole Boot Selector frame, chrome included, like the first frame of the screen
+static void renderBootSelector(uint32_t selectedIndex) {
+    DisplayList displayList;
+    displayList.setStaticContent(drawMenuScreenChrome);
+    drawMenuScreen(displayList, menu, selectedIndex, 2, false);
+}
+
+static void benchmarkBootSelector() {
+    const uint32_t rounds = 1000;
+    struct Config {
+        const char *name;
+        bool glyphCache;
+        bool sdfText;
+    };
+    const Config configs[] = {
+            {"glyph cache", true, true},
+            {"no glyph cache, SDF resampling", false, true},
+            {"no glyph cache, no SDF", false, false},
+    };
+    uint32_t hashes[3] = {};
+    for (uint32_t i = 0; i < 3; i++) {
+        DrawUtils::setGlyphCacheEnabled(configs[i].glyphCache);
+        DrawUtils::setSdfTextEnabled(configs[i].sdfText);
+        MemoryScreen screen;
+        CHECK(screen.isValid(), "failed to set up the screen, is fonts/Lato-Regular.ttf missing?");
+        if (!screen.isValid()) {
+            break;
+        }
+        hashes[i]      = screen.hashFrame([]() { renderBootSelector(1); });
+        uint32_t frame = 0;
+        double us      = MemoryScreen::frameTimeUs(rounds, [&frame]() { renderBootSelector(frame++ % menu.size()); });
+        printf("GlyphCacheTest: Boot Selector x%u with %-31s %7.1f us per frame\n", rounds, configs[i].name, us);
+    }
+    DrawUtils::setGlyphCacheEnabled(true);
+    DrawUtils::setSdfTextEnabled(true);
+    CHECK(hashes[0] == hashes[1], "the Boot Selector looks different without the glyph cache: %08X, %08X", hashes[0], hashes[1]);
+}
+
+int main() {
+    testLruEviction();
+    testCompaction();
+    benchmarkBootSelector();
+    return testResult("GlyphCacheTest");
+}
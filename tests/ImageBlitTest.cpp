@@ -0,0 +1,122 @@
+#include "TestUtils.h"
+#include "host/MemoryScreen.h"
+#include <png.h>
+#include <vector>
+
+/**
+ * Checks that a PNG decoded by DecodedImage draws the same as its source pixels and as drawPNG, then measures
+ * decoding it and blitting it with drawImage separately, since screens decode their images once and blit them every
+ * frame.
+ */
+
+struct TestImage {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> rgba;
+    std::vector<uint8_t> png;
+};
+
+// a gradient, opaque or as a disc on a transparent background with a translucent rim
+static TestImage makeImage(const char *name, uint32_t width, uint32_t height, bool disc) {
+    TestImage image = {name, width, height, std::vector<uint8_t>(width * height * 4), {}};
+    uint8_t *pixel  = image.rgba.data();
+    int32_t radius  = (int32_t) (width < height ? width : height) / 2;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++, pixel += 4) {
+            int32_t dx = (int32_t) x - (int32_t) width / 2;
+            int32_t dy = (int32_t) y - (int32_t) height / 2;
+            int32_t d  = dx * dx + dy * dy;
+            pixel[0]   = (uint8_t) (x * 255 / width);
+            pixel[1]   = (uint8_t) (y * 255 / height);
+            pixel[2]   = (uint8_t) ((x + y) * 3);
+            pixel[3]   = !disc ? 0xFF : (d < (radius - 8) * (radius - 8) ? 0xFF : (d < radius * radius ? 0x60 : 0x00));
+        }
+    }
+
+    png_image png = {};
+    png.version   = PNG_IMAGE_VERSION;
+    png.width     = width;
+    png.height    = height;
+    png.format    = PNG_FORMAT_RGBA;
+    png_alloc_size_t size = 0;
+    if (png_image_write_get_memory_size(png, size, 0, image.rgba.data(), 0, nullptr)) {
+        image.png.resize(size);
+        if (!png_image_write_to_memory(&png, image.png.data(), &size, 0, image.rgba.data(), 0, nullptr)) {
+            image.png.clear();
+        }
+    }
+    return image;
+}
+
+static void testDecodedImage(MemoryScreen &screen, const TestImage &image) {
+    DecodedImage decoded;
+    DecodedImage loaded;
+    CHECK(decoded.decodePNG(image.png.data(), image.png.size()), "%s: failed to decode", image.name);
+    CHECK(loaded.loadPixels((const uint32_t *) image.rgba.data(), image.width, image.height), "%s: failed to load the pixels", image.name);
+    CHECK(decoded.getWidth() == image.width && decoded.getHeight() == image.height, "%s: decoded %ux%u", image.name, decoded.getWidth(), decoded.getHeight());
+
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        // at the origin, partly off screen and in a clip rect
+        const Rect clips[] = {Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT), Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT), Rect(30, 20, 57, 300)};
+        const uint32_t positions[][2] = {{0, 0}, {SCREEN_WIDTH - 40, SCREEN_HEIGHT - 30}, {10, 5}};
+        for (uint32_t i = 0; i < 3; i++) {
+            uint32_t x = positions[i][0], y = positions[i][1];
+            auto draw  = [&](const std::function<void()> &blit) {
+                return screen.hashFrame([&]() {
+                    // something to blend with
+                    DrawUtils::drawRectFilled(0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT, Color(128, 64, 32, 255));
+                    DrawUtils::setClipRect(clips[i]);
+                    blit();
+                    DrawUtils::resetClipRect();
+                });
+            };
+            uint32_t expected = draw([&]() { DrawUtils::drawImage(x, y, loaded); });
+            uint32_t actual   = draw([&]() { DrawUtils::drawImage(x, y, decoded); });
+            uint32_t png      = draw([&]() { DrawUtils::drawPNG(x, y, image.png.data(), image.png.size()); });
+            CHECK(actual == expected, "%s %s at %u,%u: decoded %08X, source pixels %08X", canvas ? "canvas" : "direct", image.name, x, y, actual, expected);
+            CHECK(png == expected, "%s %s at %u,%u: drawPNG %08X, source pixels %08X", canvas ? "canvas" : "direct", image.name, x, y, png, expected);
+        }
+    }
+    DrawUtils::setCanvasEnabled(true);
+}
+
+static void benchmarkImage(const TestImage &image) {
+    const uint32_t rounds = image.width * image.height > 128 * 128 ? 20 : 200;
+    DecodedImage decoded;
+    double decodeUs = MemoryScreen::timeUs(rounds, [&]() { decoded.decodePNG(image.png.data(), image.png.size()); });
+
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        DrawUtils::beginDraw();
+        DrawUtils::clear(Color(32, 32, 64, 255));
+        double blitUs = MemoryScreen::timeUs(rounds, [&]() { DrawUtils::drawImage(0, 0, decoded); });
+        double pngUs  = MemoryScreen::timeUs(rounds, [&]() { DrawUtils::drawPNG(0, 0, image.png.data(), image.png.size()); });
+        DrawUtils::endDraw();
+        printf("ImageBlitTest: %-20s %s: decodePNG %8.1f us, drawImage %7.1f us, drawPNG %8.1f us\n", image.name, canvas ? "canvas" : "direct", decodeUs,
+               blitUs, pngUs);
+    }
+    DrawUtils::setCanvasEnabled(true);
+}
+
+int main() {
+    MemoryScreen screen;
+    CHECK(screen.isValid(), "failed to set up the screen, is fonts/Lato-Regular.ttf missing?");
+    if (!screen.isValid()) {
+        return testResult("ImageBlitTest");
+    }
+    const TestImage images[] = {
+            makeImage("128x128 disc", 128, 128, true),
+            makeImage("128x128 opaque", 128, 128, false),
+            makeImage("854x480 opaque", SCREEN_WIDTH, SCREEN_HEIGHT, false),
+    };
+    for (const auto &image : images) {
+        CHECK(!image.png.empty(), "%s: failed to encode the PNG", image.name);
+        if (!image.png.empty()) {
+            testDecodedImage(screen, image);
+            benchmarkImage(image);
+        }
+    }
+    return testResult("ImageBlitTest");
+}
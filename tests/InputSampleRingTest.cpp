@@ -0,0 +1,126 @@
+#include "TestUtils.h"
+#include "utils/InputSampleRing.h"
+#include <thread>
+
+static void testWraparound() {
+    InputSampleRing<uint32_t, 8> ring;
+    uint32_t next     = 0;
+    uint32_t expected = 0;
+    // push and pop in uneven steps, so head and tail pass the end of the array at different offsets
+    for (uint32_t round = 0; round < 100; round++) {
+        for (uint32_t i = 0; i < 1 + round % 8; i++) {
+            CHECK(ring.push(next), "push %u failed", next);
+            next++;
+        }
+        for (uint32_t i = 0; i < 1 + round % 5; i++) {
+            uint32_t sample = 0;
+            if (!ring.pop(sample)) {
+                break;
+            }
+            CHECK(sample == expected, "popped %u, expected %u", sample, expected);
+            expected++;
+        }
+        uint32_t taken = ring.drain([&expected](uint32_t sample) {
+            CHECK(sample == expected, "drained %u, expected %u", sample, expected);
+            expected++;
+            return true;
+        });
+        CHECK(taken <= 8, "drained %u samples from a ring of 8", taken);
+    }
+    uint32_t sample = 0;
+    CHECK(!ring.pop(sample), "ring isn't empty after draining");
+    CHECK(expected == next, "took %u of %u samples", expected, next);
+    CHECK(ring.getPushed() == next, "getPushed is %u, expected %u", ring.getPushed(), next);
+    CHECK(ring.getDropped() == 0, "dropped %u samples", ring.getDropped());
+}
+
+static void testDropsWhenFull() {
+    InputSampleRing<uint32_t, 4> ring;
+    for (uint32_t i = 0; i < 4; i++) {
+        CHECK(ring.push(i), "push %u into a ring with free space failed", i);
+    }
+    CHECK(!ring.push(4), "push into a full ring succeeded");
+    CHECK(!ring.push(5), "push into a full ring succeeded");
+    CHECK(ring.getDropped() == 2, "dropped %u samples, expected 2", ring.getDropped());
+    CHECK(ring.getPushed() == 4, "getPushed is %u, expected 4", ring.getPushed());
+
+    // the oldest samples are kept, the dropped ones never show up
+    uint32_t sample = 0;
+    CHECK(ring.pop(sample) && sample == 0, "popped %u, expected 0", sample);
+    CHECK(ring.push(6), "push after pop failed");
+    uint32_t expected[] = {1, 2, 3, 6};
+    uint32_t count      = 0;
+    ring.drain([&](uint32_t sample) {
+        CHECK(count < 4 && sample == expected[count], "drained %u at %u", sample, count);
+        count++;
+        return true;
+    });
+    CHECK(count == 4, "drained %u samples, expected 4", count);
+}
+
+static void testPartialDrain() {
+    InputSampleRing<uint32_t, 8> ring;
+    // start close to the end of the array, so the kept samples wrap around
+    for (uint32_t i = 0; i < 6; i++) {
+        ring.push(100);
+        uint32_t sample = 0;
+        ring.pop(sample);
+    }
+    for (uint32_t i = 0; i < 6; i++) {
+        ring.push(i);
+    }
+
+    // stops at the first sample func rejects and leaves it in the ring
+    uint32_t seen  = 0;
+    uint32_t taken = ring.drain([&seen](uint32_t sample) {
+        seen++;
+        return sample < 3;
+    });
+    CHECK(taken == 3, "took %u samples, expected 3", taken);
+    CHECK(seen == 4, "func saw %u samples, expected 4", seen);
+
+    taken = ring.drain([](uint32_t) { return false; });
+    CHECK(taken == 0, "took %u samples when func rejects everything", taken);
+
+    uint32_t sample = 0;
+    for (uint32_t i = 3; i < 6; i++) {
+        CHECK(ring.pop(sample) && sample == i, "popped %u, expected %u", sample, i);
+    }
+    CHECK(!ring.pop(sample), "ring isn't empty");
+
+    taken = ring.drain([](uint32_t) { return true; });
+    CHECK(taken == 0, "took %u samples from an empty ring", taken);
+}
+
+static void testProducerConsumer() {
+    static InputSampleRing<uint32_t, 16> ring;
+    const uint32_t count = 200000;
+    std::thread producer([count] {
+        for (uint32_t i = 0; i < count; i++) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t expected = 0;
+    while (expected < count) {
+        uint32_t taken = ring.drain([&expected](uint32_t sample) {
+            CHECK(sample == expected, "drained %u, expected %u", sample, expected);
+            expected = sample + 1;
+            return true;
+        });
+        if (taken == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(ring.getPushed() == count, "getPushed is %u, expected %u", ring.getPushed(), count);
+}
+
+int main() {
+    testWraparound();
+    testDropsWhenFull();
+    testPartialDrain();
+    testProducerConsumer();
+    return testResult("InputSampleRingTest");
+}
@@ -0,0 +1,180 @@
+#include "ACTAccountInfo.h"
+#include "DrawUtils.h"
+#include "InputRecorder.h"
+#include "MenuUtils.h"
+#include "TestUtils.h"
+#include "UiSession.h"
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+
+/**
+ * Runs the Boot Selector and the account selection headless: DrawUtils draws into memory and the input comes from
+ * recordings of scripted button presses, which InputRecorder plays back frame by frame. Both screens run twice and
+ * have to draw the same frames each time, their frame count, draw time per frame and the hash over all frames are
+ * printed to compare changes of the renderer.
+ */
+
+struct ScriptStep {
+    uint32_t buttons; // held for the whole step
+    uint32_t frames;
+};
+
+/**
+ * Records the script as it would have been read by a menu loop, one frame per scheduler frame.
+ */
+static bool recordScript(const std::string &path, std::initializer_list<ScriptStep> steps) {
+    InputRecorder::startRecording();
+    uint32_t hold = 0;
+    for (const auto &step : steps) {
+        for (uint32_t i = 0; i < step.frames; i++) {
+            // the menu loops start each frame with waitForNextFrame, so the recording does as well
+            InputRecorder::nextFrame();
+            InputUtils::InputData input = {};
+            input.trigger               = step.buttons & ~hold;
+            input.release               = hold & ~step.buttons;
+            input.hold                  = step.buttons;
+            InputRecorder::record(input);
+            hold = step.buttons;
+        }
+    }
+    return InputRecorder::saveRecording(path);
+}
+
+static std::shared_ptr<AccountInfo> makeAccount(uint32_t index) {
+    auto account  = std::make_shared<AccountInfo>();
+    account->slot = index + 1;
+    account->name = "Player " + std::to_string(index + 1);
+    snprintf(account->accountId, sizeof(account->accountId), "player%d", index + 1);
+    account->isNetworkAccount = index % 2 == 0;
+
+    // 128x128 ARGB with the background the account selection removes, and a disc in the middle
+    uint8_t *pixel = account->miiImageBuffer;
+    for (uint32_t y = 0; y < 128; y++) {
+        for (uint32_t x = 0; x < 128; x++, pixel += 4) {
+            int32_t dx  = (int32_t) x - 64;
+            int32_t dy  = (int32_t) y - 64;
+            bool inside = dx * dx + dy * dy < 40 * 40;
+            pixel[0]    = inside ? 0xFF : 0x00;
+            pixel[1]    = inside ? (uint8_t) (x * 2) : 0x80;
+            pixel[2]    = inside ? (uint8_t) (y * 2) : 0x80;
+            pixel[3]    = inside ? (uint8_t) (index * 36) : 0x80;
+        }
+    }
+    account->miiImageSize = 128 * 128 * 4;
+    return account;
+}
+
+struct RunResult {
+    uint32_t frames;
+    uint64_t drawTimeUs;
+    uint32_t hash;
+};
+
+static RunResult runBootSelector(const std::string &configPath) {
+    const std::map<uint32_t, std::string> menu = {
+            {BOOT_OPTION_WII_U_MENU, "Wii U Menu"},
+            {BOOT_OPTION_HOMEBREW_LAUNCHER, "Homebrew Launcher"},
+            {BOOT_OPTION_VWII_SYSTEM_MENU, "vWii System Menu"},
+            {BOOT_OPTION_VWII_HOMEBREW_CHANNEL, "vWii Homebrew Channel"},
+    };
+    remove(configPath.c_str());
+    CHECK(InputRecorder::startReplay("build/BootSelector.rec"), "failed to replay build/BootSelector.rec");
+
+    UiSession session;
+    std::string path = configPath;
+    int32_t selected = handleMenuScreen(session, path, readAutobootOption(path), menu);
+    session.shutdown();
+    RunResult res = {DrawUtils::getFrameCount(), DrawUtils::getDrawTimeUs(), DrawUtils::getFramesHash()};
+
+    CHECK(selected == BOOT_OPTION_VWII_SYSTEM_MENU, "selected %d", selected);
+    CHECK(readAutobootOption(path) == BOOT_OPTION_VWII_SYSTEM_MENU, "autoboot option %d", readAutobootOption(path));
+    return res;
+}
+
+static RunResult runAccountSelection() {
+    std::vector<std::shared_ptr<AccountInfo>> accounts;
+    for (uint32_t i = 0; i < 7; i++) {
+        accounts.push_back(makeAccount(i));
+    }
+    CHECK(InputRecorder::startReplay("build/AccountSelection.rec"), "failed to replay build/AccountSelection.rec");
+
+    UiSession session;
+    nn::act::SlotNo slot = handleAccountSelectScreen(session, accounts);
+    session.shutdown();
+    RunResult res = {DrawUtils::getFrameCount(), DrawUtils::getDrawTimeUs(), DrawUtils::getFramesHash()};
+
+    CHECK(slot == 6, "selected slot %d", slot);
+    return res;
+}
+
+static void report(const char *screen, const RunResult &first, const RunResult &second) {
+    CHECK(first.frames > 0, "%s drew no frames", screen);
+    CHECK(first.frames == second.frames && first.hash == second.hash, "%s drew %u frames (%08X), then %u frames (%08X)", screen, first.frames, first.hash,
+          second.frames, second.hash);
+    if (first.frames > 0 && second.frames > 0) {
+        printf("MenuRunner: %-17s %3u frames, %6.1f us per frame (first run %6.1f us), frames hash %08X\n", screen, second.frames,
+               (double) second.drawTimeUs / second.frames, (double) first.drawTimeUs / first.frames, second.hash);
+    }
+}
+
+int main() {
+    DrawUtils::setMemoryBackend(true);
+
+    // Boot Selector: move down, hold + and - to toggle the update blocking (which fails without the MLC),
+    // select vWii System Menu as autoboot, move up and down again and boot it
+    bool recorded = recordScript("build/BootSelector.rec", {
+                                                                   {0, 5},
+                                                                   {VPAD_BUTTON_DOWN, 1},
+                                                                   {0, 3},
+                                                                   {VPAD_BUTTON_PLUS | VPAD_BUTTON_MINUS, 60},
+                                                                   {0, 3},
+                                                                   {VPAD_BUTTON_DOWN, 1},
+                                                                   {0, 3},
+                                                                   {VPAD_BUTTON_Y, 1},
+                                                                   {0, 3},
+                                                                   {VPAD_BUTTON_UP, 1},
+                                                                   {0, 3},
+                                                                   {VPAD_BUTTON_DOWN, 1},
+                                                                   {0, 3},
+                                                                   {VPAD_BUTTON_A, 1},
+                                                           });
+    // account selection: page through all 7 accounts, go back to the 6th one and choose it
+    recorded = recorded && recordScript("build/AccountSelection.rec", {
+                                                                              {0, 5},
+                                                                              {VPAD_BUTTON_DOWN, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_DOWN, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_DOWN, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_DOWN, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_DOWN, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_DOWN, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_UP, 2},
+                                                                              {0, 2},
+                                                                              {VPAD_BUTTON_A, 1},
+                                                                      });
+    CHECK(recorded, "failed to record the input");
+    if (!recorded) {
+        return testResult("MenuRunner");
+    }
+
+    // the second run starts with the glyph cache file of the first one
+    DrawUtils::setGlyphCacheFile("build/MenuRunner.glyphs");
+    remove("build/MenuRunner.glyphs");
+    RunResult bootSelector[2];
+    RunResult accountSelection[2];
+    for (uint32_t run = 0; run < 2; run++) {
+        bootSelector[run]     = runBootSelector("build/MenuRunner.cfg");
+        accountSelection[run] = runAccountSelection();
+    }
+    report("Boot Selector", bootSelector[0], bootSelector[1]);
+    report("Account Selection", accountSelection[0], accountSelection[1]);
+
+    return testResult("MenuRunner");
+}
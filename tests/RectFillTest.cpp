@@ -0,0 +1,169 @@
+#include "DisplayList.h"
+#include "MenuUtils.h"
+#include "TestUtils.h"
+#include "host/MemoryScreen.h"
+
+/**
+ * Checks that the span fills of drawRectFilled and drawRect produce the same frames as filling every pixel with
+ * drawPixel, and compares the frame time of the Boot Selector drawn both ways and through drawMenuScreen.
+ */
+
+// MenuUtils.cpp doesn't export them, the menus only call them itself
+void drawMenuScreenChrome();
+void drawMenuScreen(DisplayList &displayList, const std::map<uint32_t, std::string> &menu, uint32_t selectedIndex, uint32_t autobootIndex, bool updatesBlocked);
+
+static void fillPerPixel(uint32_t x, uint32_t y, uint32_t w, uint32_t h, Color col) {
+    for (uint32_t yy = y; yy < y + h; yy++) {
+        for (uint32_t xx = x; xx < x + w; xx++) {
+            DrawUtils::drawPixel(xx, yy, col);
+        }
+    }
+}
+
+static void borderPerPixel(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t borderSize, Color col) {
+    if (borderSize * 2 >= w || borderSize * 2 >= h) {
+        fillPerPixel(x, y, w, h, col);
+        return;
+    }
+    fillPerPixel(x, y, w, borderSize, col);
+    fillPerPixel(x, y + h - borderSize, w, borderSize, col);
+    fillPerPixel(x, y + borderSize, borderSize, h - borderSize * 2, col);
+    fillPerPixel(x + w - borderSize, y + borderSize, borderSize, h - borderSize * 2, col);
+}
+
+struct RectCase {
+    Rect rect; // x1/y1 hold width and height, they may reach past the screen
+    uint32_t borderSize;
+    Rect clip;
+};
+
+static void testFillsMatchPixels(MemoryScreen &screen) {
+    const Rect fullScreen(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    const RectCase cases[] = {
+            {{8, 36, SCREEN_WIDTH - 16, 3}, 0, fullScreen},
+            {{16, 44, SCREEN_WIDTH - 32, 44}, 4, fullScreen},
+            {{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}, 0, fullScreen},
+            {{SCREEN_WIDTH - 10, SCREEN_HEIGHT - 10, 50, 50}, 3, fullScreen},
+            {{1, 1, 1, 1}, 0, fullScreen},
+            {{100, 100, 400, 200}, 7, Rect(150, 120, 101, 333)},
+            {{0, 0, 300, 300}, 0, Rect(299, 0, 1, 480)},
+            {{200, 200, 10, 10}, 0, Rect(0, 0, 100, 100)},
+    };
+    const Color colors[] = {Color(0x3478e4ff), Color(0xaeea0080), Color(255, 255, 255, 1), Color(0xffffff00)};
+
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        for (const auto &c : cases) {
+            for (const auto &col : colors) {
+                uint32_t x = c.rect.x0, y = c.rect.y0, w = c.rect.x1 - c.rect.x0, h = c.rect.y1 - c.rect.y0;
+                auto draw  = [&](bool perPixel) {
+                    return screen.hashFrame([&]() {
+                        // something to blend with
+                        DrawUtils::drawRectFilled(0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT, Color(0x804020ff));
+                        DrawUtils::setClipRect(c.clip);
+                        if (perPixel) {
+                            c.borderSize ? borderPerPixel(x, y, w, h, c.borderSize, col) : fillPerPixel(x, y, w, h, col);
+                        } else {
+                            c.borderSize ? DrawUtils::drawRect(x, y, w, h, c.borderSize, col) : DrawUtils::drawRectFilled(x, y, w, h, col);
+                        }
+                        DrawUtils::resetClipRect();
+                    });
+                };
+                uint32_t expected = draw(true);
+                uint32_t actual   = draw(false);
+                CHECK(expected == actual, "%s %ux%u at %u,%u (border %u) in %08X: %08X, per pixel %08X", canvas ? "canvas" : "direct", w, h, x, y, c.borderSize,
+                      col.color, actual, expected);
+            }
+        }
+    }
+    DrawUtils::setCanvasEnabled(true);
+}
+
+static const std::map<uint32_t, std::string> menu = {
+        {BOOT_OPTION_WII_U_MENU, "Wii U Menu"},
+        {BOOT_OPTION_HOMEBREW_LAUNCHER, "Homebrew Launcher"},
+        {BOOT_OPTION_VWII_SYSTEM_MENU, "vWii System Menu"},
+        {BOOT_OPTION_VWII_HOMEBREW_CHANNEL, "vWii Homebrew Channel"},
+};
+
+/**
+ * The bars and the item borders of the Boot Selector, as drawMenuScreenChrome and drawMenuScreen place them.
+ */
+static void drawBootSelectorRects(bool perPixel, uint32_t selectedIndex) {
+    auto fill   = perPixel ? fillPerPixel : DrawUtils::drawRectFilled;
+    auto border = perPixel ? borderPerPixel : DrawUtils::drawRect;
+    fill(8, 8 + 24 + 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
+    fill(8, SCREEN_HEIGHT - 24 - 8 - 4, SCREEN_WIDTH - 8 * 2, 3, COLOR_WHITE);
+
+    uint32_t index = 8 + 24 + 8 + 4;
+    for (uint32_t i = 0; i < menu.size(); i++) {
+        if (i == selectedIndex) {
+            border(16, index, SCREEN_WIDTH - 16 * 2, 44, 4, COLOR_BORDER_HIGHLIGHTED);
+        } else {
+            border(16, index, SCREEN_WIDTH - 16 * 2, 44, 2, COLOR_BORDER);
+        }
+        index += 42 + 8;
+    }
+}
+
+/**
+ * The whole Boot Selector in one immediate frame.
+ */
+static void drawBootSelector(bool perPixel, uint32_t selectedIndex) {
+    DrawUtils::beginDraw();
+    DrawUtils::clear(COLOR_BACKGROUND);
+    drawBootSelectorRects(perPixel, selectedIndex);
+
+    DrawUtils::setFontColor(COLOR_TEXT);
+    DrawUtils::setFontSize(24);
+    DrawUtils::print(16, 6 + 24, "Boot Selector");
+    DrawUtils::setFontSize(18);
+    DrawUtils::print(16, SCREEN_HEIGHT - 8, "\ue07d Navigate ");
+    DrawUtils::print(SCREEN_WIDTH - 16, SCREEN_HEIGHT - 8, "\ue000 Choose", TEXT_ALIGN_RIGHT);
+    uint32_t index = 8 + 24 + 8 + 4;
+    DrawUtils::setFontSize(24);
+    for (const auto &item : menu) {
+        DrawUtils::print(16 * 2, index + 8 + 24, item.second);
+        index += 42 + 8;
+    }
+    DrawUtils::endDraw();
+}
+
+static void benchmarkMenuScreen(MemoryScreen &screen) {
+    const uint32_t rounds = 300;
+    uint32_t frame        = 0;
+    // the same frame both ways first, which also renders every glyph once
+    CHECK(screen.hashFrame([]() { drawBootSelector(true, 1); }) == screen.hashFrame([]() { drawBootSelector(false, 1); }), "the Boot Selector frames differ");
+
+    double perPixelUs = MemoryScreen::frameTimeUs(rounds, [&]() { drawBootSelector(true, frame++ % menu.size()); });
+    double spansUs    = MemoryScreen::frameTimeUs(rounds, [&]() { drawBootSelector(false, frame++ % menu.size()); });
+    printf("RectFillTest: Boot Selector frame with per-pixel fills %.1f us, with span fills %.1f us (%.1fx)\n", perPixelUs, spansUs, perPixelUs / spansUs);
+
+    // only the rectangles of a frame, without the clear, the text and presenting the frame
+    DrawUtils::beginDraw();
+    perPixelUs = MemoryScreen::timeUs(rounds, [&]() { drawBootSelectorRects(true, frame++ % menu.size()); });
+    spansUs    = MemoryScreen::timeUs(rounds, [&]() { drawBootSelectorRects(false, frame++ % menu.size()); });
+    DrawUtils::endDraw();
+    printf("RectFillTest: Boot Selector rectangles per pixel %.1f us, as spans %.1f us (%.1fx)\n", perPixelUs, spansUs, perPixelUs / spansUs);
+
+    // drawMenuScreen itself, repainting everything each frame or only what a move of the selection changed
+    DisplayList displayList;
+    displayList.setStaticContent(drawMenuScreenChrome);
+    double fullUs = MemoryScreen::frameTimeUs(rounds, [&]() {
+        displayList.invalidate();
+        drawMenuScreen(displayList, menu, frame++ % menu.size(), 2, false);
+    });
+    double moveUs = MemoryScreen::frameTimeUs(rounds, [&]() { drawMenuScreen(displayList, menu, frame++ % menu.size(), 2, false); });
+    printf("RectFillTest: drawMenuScreen full repaint %.1f us, selection move %.1f us\n", fullUs, moveUs);
+}
+
+int main() {
+    MemoryScreen screen;
+    CHECK(screen.isValid(), "failed to set up the screen, is fonts/Lato-Regular.ttf missing?");
+    if (!screen.isValid()) {
+        return testResult("RectFillTest");
+    }
+    testFillsMatchPixels(screen);
+    benchmarkMenuScreen(screen);
+    return testResult("RectFillTest");
+}
@@ -0,0 +1,130 @@
+#include "TestUtils.h"
+#include "schrift.h"
+#include "utils/SdfGlyph.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+/**
+ * Compares the glyphs resampled from distance fields with the glyphs rasterized directly in the same size, over the
+ * printable ASCII and Latin-1 characters of the test font. Pixels where either side is only partially covered are
+ * the edge, that's where resampling rounds corners and loses thin details. The limits are what the current
+ * distance fields reach plus about 30%, a regression in their quality or in the resampling breaks them.
+ */
+struct SizeLimits {
+    uint32_t size;
+    double maxMeanEdgeError; // mean absolute coverage error on edge pixels, 0-255
+    double maxFlippedRatio;  // pixels that are inside on one side and outside on the other
+};
+
+struct GlyphBox {
+    SFT_Glyph gid;
+    SFT_GMetrics mtx;
+    int32_t width;
+    int32_t height;
+};
+
+static bool loadGlyph(SFT &sft, uint32_t codepoint, uint32_t size, GlyphBox &box) {
+    sft.xScale = size;
+    sft.yScale = size;
+    if (sft_lookup(&sft, codepoint, &box.gid) < 0 || box.gid == 0 || sft_gmetrics(&sft, box.gid, &box.mtx) < 0) {
+        return false;
+    }
+    // same boxes as DrawUtils
+    box.width  = (box.mtx.minWidth + 3) & ~3;
+    box.height = box.mtx.minHeight;
+    return box.mtx.minWidth > 0 && box.mtx.minHeight > 0;
+}
+
+int main() {
+    std::vector<uint8_t> font = readFile("fonts/Lato-Regular.ttf");
+    CHECK(!font.empty(), "fonts/Lato-Regular.ttf missing");
+    if (font.empty()) {
+        return testResult("SdfEdgeTest");
+    }
+    SFT sft   = {};
+    sft.flags = SFT_DOWNWARD_Y;
+    sft.font  = sft_loadmem(font.data(), font.size());
+    CHECK(sft.font != nullptr, "failed to load the font");
+    if (!sft.font) {
+        return testResult("SdfEdgeTest");
+    }
+
+    std::vector<uint32_t> codepoints;
+    for (uint32_t c = 0x21; c < 0x7F; c++) {
+        codepoints.push_back(c);
+    }
+    for (uint32_t c = 0xA1; c <= 0xFF; c++) {
+        codepoints.push_back(c);
+    }
+
+    // render the distance fields once, like the glyph cache does
+    struct Sdf {
+        GlyphBox box;
+        int32_t width = 0;
+        int32_t height = 0;
+        std::vector<uint8_t> pixels;
+    };
+    std::vector<Sdf> sdfs(codepoints.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < codepoints.size(); i++) {
+        Sdf &sdf = sdfs[i];
+        if (!loadGlyph(sft, codepoints[i], SDF_REFERENCE_SIZE, sdf.box)) {
+            continue;
+        }
+        sdf.width  = (sdf.box.mtx.minWidth + SDF_PADDING * 2 + 3) & ~3;
+        sdf.height = sdf.box.mtx.minHeight + SDF_PADDING * 2;
+        sdf.pixels.resize(sdf.width * sdf.height);
+        SFT_Image img = {sdf.pixels.data(), sdf.width, sdf.height};
+        CHECK(sft_render_sdf(&sft, sdf.box.gid, img, SDF_PADDING) >= 0, "U+%04X: sft_render_sdf failed", codepoints[i]);
+    }
+    double sdfMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("SdfEdgeTest: %zu distance fields in %.2f ms\n", codepoints.size(), sdfMs);
+
+    const SizeLimits limits[] = {
+            {12, 11.0, 0.022},
+            {16, 10.0, 0.009},
+            {24, 8.5, 0.005},
+            {36, 6.5, 0.003},
+            {48, 13.0, 0.0085},
+            {72, 25.0, 0.0125},
+    };
+    for (const auto &limit : limits) {
+        uint64_t edgePixels = 0, edgeError = 0, flipped = 0, total = 0;
+        for (size_t i = 0; i < codepoints.size(); i++) {
+            const Sdf &sdf = sdfs[i];
+            GlyphBox box;
+            if (sdf.pixels.empty() || !loadGlyph(sft, codepoints[i], limit.size, box)) {
+                continue;
+            }
+            std::vector<uint8_t> direct(box.width * box.height);
+            std::vector<uint8_t> resampled(box.width * box.height);
+            SFT_Image img = {direct.data(), box.width, box.height};
+            CHECK(sft_render(&sft, box.gid, img) >= 0, "U+%04X size %u: sft_render failed", codepoints[i], limit.size);
+            ResampleSdf(sdf.pixels.data(), sdf.width, sdf.height, (float) floor(sdf.box.mtx.leftSideBearing), (float) -sdf.box.mtx.yOffset,
+                        resampled.data(), box.width, box.height, (float) floor(box.mtx.leftSideBearing), (float) -box.mtx.yOffset,
+                        (float) SDF_REFERENCE_SIZE / (float) limit.size);
+
+            for (size_t p = 0; p < direct.size(); p++) {
+                total++;
+                if ((direct[p] >= 128) != (resampled[p] >= 128)) {
+                    flipped++;
+                }
+                bool edge = (direct[p] != 0 && direct[p] != 255) || (resampled[p] != 0 && resampled[p] != 255);
+                if (edge) {
+                    edgePixels++;
+                    edgeError += abs((int32_t) direct[p] - (int32_t) resampled[p]);
+                }
+            }
+        }
+        double meanEdgeError = edgePixels ? (double) edgeError / (double) edgePixels : 0.0;
+        double flippedRatio  = total ? (double) flipped / (double) total : 0.0;
+        printf("SdfEdgeTest: size %2u: mean edge error %5.2f/255 over %llu pixels, %.2f%% of the pixels flipped\n",
+               limit.size, meanEdgeError, (unsigned long long) edgePixels, flippedRatio * 100.0);
+        CHECK(meanEdgeError <= limit.maxMeanEdgeError, "size %u: mean edge error %.2f", limit.size, meanEdgeError);
+        CHECK(flippedRatio <= limit.maxFlippedRatio, "size %u: %.4f of the pixels flipped", limit.size, flippedRatio);
+    }
+
+    sft_freefont(sft.font);
+    return testResult("SdfEdgeTest");
+}
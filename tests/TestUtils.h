@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+static int failedChecks = 0;
+
+#define CHECK(cond, ...)                                                    \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            failedChecks++;                                                 \
+            printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+            printf(__VA_ARGS__);                                            \
+            printf("\n");                                                   \
+        }                                                                   \
+    } while (0)
+
+/**
+ * Prints the result of a test and returns its exit code.
+ */
+static int testResult(const char *name) {
+    if (failedChecks != 0) {
+        printf("%s: %d checks failed\n", name, failedChecks);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+/**
+ * Reads a whole file, e.g. one of the fonts in fonts/. Returns an empty vector if it can't be read.
+ */
+[[maybe_unused]] static std::vector<uint8_t> readFile(const char *path) {
+    std::vector<uint8_t> data;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return data;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size > 0) {
+        data.resize(size);
+        if (fread(data.data(), 1, size, f) != (size_t) size) {
+            data.clear();
+        }
+    }
+    fclose(f);
+    return data;
+}
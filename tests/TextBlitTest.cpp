@@ -0,0 +1,106 @@
+#include "TestUtils.h"
+#include "host/MemoryScreen.h"
+#include <cstring>
+
+/**
+ * Checks that clipped text matches unclipped text with everything outside the clip rect cleared, and measures how
+ * long full paragraphs take to print once their glyphs are cached, so mostly the coverage blits.
+ */
+
+static const char *paragraph[] = {
+        "The Wii U Menu, the Homebrew Launcher, the vWii System Menu and",
+        "the vWii Homebrew Channel can be booted from the Boot Selector.",
+        "Hold + and - to delete or restore the update folder, which keeps",
+        "the console from installing system updates. Press X or - to clear",
+        "the autoboot option and Y or + to boot the selected entry directly.",
+        "(0123456789) Select your Account: Player_1 Player-2 Player.3 A/B",
+};
+
+static uint32_t printParagraph(uint32_t x, uint32_t y, uint32_t fontSize) {
+    uint32_t glyphs = 0;
+    DrawUtils::setFontSize(fontSize);
+    for (const char *line : paragraph) {
+        DrawUtils::print(x, y, line);
+        glyphs += strlen(line);
+        y += fontSize + fontSize / 4;
+    }
+    return glyphs;
+}
+
+static void testClippedText(MemoryScreen &screen) {
+    const Rect clips[] = {
+            Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT),
+            Rect(100, 50, 300, 120),
+            Rect(23, 61, 1, 200),
+            Rect(400, 0, 454, 17),
+    };
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        for (const auto &clip : clips) {
+            // starts left of and above the screen as well, so glyphs are cut off by the screen edges
+            for (int32_t start : {16, -7}) {
+                auto x = (uint32_t) start;
+                auto y = (uint32_t) start + 24;
+                DrawUtils::setFontColor(Color(255, 255, 255, 255));
+                uint32_t clipped = screen.hashFrame([&]() {
+                    DrawUtils::setClipRect(clip);
+                    printParagraph(x, y, 24);
+                    DrawUtils::resetClipRect();
+                });
+                uint32_t expected = screen.hashFrame([&]() {
+                    printParagraph(x, y, 24);
+                    // clear everything outside the clip rect
+                    const Rect outside[] = {
+                            Rect(0, 0, SCREEN_WIDTH, clip.y0),
+                            Rect(0, clip.y1, SCREEN_WIDTH, SCREEN_HEIGHT - clip.y1),
+                            Rect(0, clip.y0, clip.x0, clip.y1 - clip.y0),
+                            Rect(clip.x1, clip.y0, SCREEN_WIDTH - clip.x1, clip.y1 - clip.y0),
+                    };
+                    for (const auto &rect : outside) {
+                        if (!rect.empty()) {
+                            DrawUtils::setClipRect(rect);
+                            DrawUtils::clear(Color(0, 0, 0, 255));
+                        }
+                    }
+                    DrawUtils::resetClipRect();
+                });
+                CHECK(clipped == expected, "%s text at %d in clip %d,%d-%d,%d: %08X, expected %08X", canvas ? "canvas" : "direct", start, clip.x0, clip.y0,
+                      clip.x1, clip.y1, clipped, expected);
+            }
+        }
+    }
+    DrawUtils::setCanvasEnabled(true);
+}
+
+static void benchmarkParagraphs() {
+    const uint32_t rounds = 200;
+    for (bool canvas : {true, false}) {
+        DrawUtils::setCanvasEnabled(canvas);
+        for (uint32_t fontSize : {16, 24, 36}) {
+            for (Color col : {Color(255, 255, 255, 255), Color(255, 255, 255, 128)}) {
+                DrawUtils::setFontColor(col);
+                DrawUtils::beginDraw();
+                DrawUtils::clear(Color(32, 32, 64, 255));
+                // renders and caches every glyph of the paragraph
+                uint32_t glyphs = printParagraph(16, 16 + fontSize, fontSize);
+                double us       = MemoryScreen::timeUs(rounds, [fontSize]() { printParagraph(16, 16 + fontSize, fontSize); });
+                DrawUtils::endDraw();
+                printf("TextBlitTest: %s, size %2u, %-11s text: %7.1f us per paragraph of %u glyphs, %.2f us per glyph\n", canvas ? "canvas" : "direct", fontSize,
+                       col.a == 0xff ? "opaque" : "translucent", us, glyphs, us / glyphs);
+            }
+        }
+    }
+    DrawUtils::setCanvasEnabled(true);
+    DrawUtils::setFontColor(Color(255, 255, 255, 255));
+}
+
+int main() {
+    MemoryScreen screen;
+    CHECK(screen.isValid(), "failed to set up the screen, is fonts/Lato-Regular.ttf missing?");
+    if (!screen.isValid()) {
+        return testResult("TextBlitTest");
+    }
+    testClippedText(screen);
+    benchmarkParagraphs();
+    return testResult("TextBlitTest");
+}
@@ -0,0 +1,42 @@
+#include "TestUtils.h"
+#include "utils/UpscaleMap.h"
+
+#define SCREEN_WIDTH  854
+#define SCREEN_HEIGHT 480
+
+/**
+ * Compares the maps with the float scaling drawPixel used before them. It wrote (uint32_t) scale tv pixels per
+ * logical pixel starting at x * scale, which left a gap after every other (720p) or every fourth (1080p) pixel.
+ *
+ * 854 * 2.25 is 1921.5, so at 1080p the old columns ran past the right edge and the last ones got cut off. The maps
+ * spread the columns over exactly 1920 pixels instead, which moves the right half of the screen by up to two pixels.
+ */
+static void checkMode(uint32_t tvWidth, uint32_t tvHeight, float scale, int32_t maxColumnShift) {
+    uint16_t columnMap[SCREEN_WIDTH + 1];
+    uint16_t rowMap[SCREEN_HEIGHT + 1];
+    BuildUpscaleMap(columnMap, SCREEN_WIDTH, tvWidth);
+    BuildUpscaleMap(rowMap, SCREEN_HEIGHT, tvHeight);
+
+    CHECK(columnMap[0] == 0 && columnMap[SCREEN_WIDTH] == tvWidth, "%ux%u: columns cover [%u, %u)", tvWidth, tvHeight, columnMap[0], columnMap[SCREEN_WIDTH]);
+    CHECK(rowMap[0] == 0 && rowMap[SCREEN_HEIGHT] == tvHeight, "%ux%u: rows cover [%u, %u)", tvWidth, tvHeight, rowMap[0], rowMap[SCREEN_HEIGHT]);
+
+    for (uint32_t x = 0; x < SCREEN_WIDTH; x++) {
+        auto baseline = (uint32_t) (x * scale);
+        int32_t diff  = (int32_t) columnMap[x] - (int32_t) baseline;
+        CHECK(diff >= -maxColumnShift && diff <= maxColumnShift, "%ux%u: column %u starts at %u, baseline %u", tvWidth, tvHeight, x, columnMap[x], baseline);
+        // at most one tv pixel more than the baseline wrote, and never none
+        uint32_t width = columnMap[x + 1] - columnMap[x];
+        CHECK(width >= 1 && width <= (uint32_t) scale + 1, "%ux%u: column %u covers %u tv pixels", tvWidth, tvHeight, x, width);
+    }
+    for (uint32_t y = 0; y < SCREEN_HEIGHT; y++) {
+        auto baseline = (uint32_t) (y * scale);
+        CHECK(rowMap[y] == baseline, "%ux%u: row %u starts at %u, baseline %u", tvWidth, tvHeight, y, rowMap[y], baseline);
+        CHECK(rowMap[y + 1] > rowMap[y], "%ux%u: row %u covers no tv pixel", tvWidth, tvHeight, y);
+    }
+}
+
+int main() {
+    checkMode(1280, 720, 1.5f, 1);
+    checkMode(1920, 1080, 2.25f, 2);
+    return testResult("UpscaleMapTest");
+}
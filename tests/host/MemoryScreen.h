@@ -0,0 +1,84 @@
+#pragma once
+
+#include "DrawUtils.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+/**
+ * DrawUtils drawing into the memory backend with the system font loaded, set up like UiSession does it. Tests that
+ * draw link the sources of the menus and the wut stubs of host/WutStubs.cpp.
+ */
+class MemoryScreen {
+public:
+    MemoryScreen() {
+        DrawUtils::setMemoryBackend(true);
+        mBuffer = DrawUtils::InitOSScreen();
+        if (mBuffer) {
+            initBuffers();
+            mValid = DrawUtils::initFont();
+        }
+    }
+
+    MemoryScreen(const MemoryScreen &) = delete;
+
+    MemoryScreen &operator=(const MemoryScreen &) = delete;
+
+    ~MemoryScreen() {
+        if (mBuffer) {
+            DrawUtils::deinitFont();
+            DrawUtils::deinitBuffers();
+            free(mBuffer);
+        }
+    }
+
+    [[nodiscard]] bool isValid() const { return mValid; }
+
+    /**
+     * Draws a single frame on a black screen and returns the hash of its DRC content.
+     */
+    uint32_t hashFrame(const std::function<void()> &draw) {
+        // initBuffers starts the frame statistics over, so the hash only covers this frame
+        initBuffers();
+        DrawUtils::beginDraw();
+        DrawUtils::clear(Color(0, 0, 0, 255));
+        draw();
+        DrawUtils::endDraw();
+        return DrawUtils::getFramesHash();
+    }
+
+    /**
+     * Calls draw the given number of times and returns the mean time per call in microseconds.
+     */
+    static double timeUs(uint32_t rounds, const std::function<void()> &draw) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; i++) {
+            draw();
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+    }
+
+    /**
+     * Calls draw, which draws whole frames, the given number of times and returns the mean time per frame in
+     * microseconds. Unlike timeUs it only counts the time between beginDraw and endDraw, not hashing the frames.
+     */
+    static double frameTimeUs(uint32_t rounds, const std::function<void()> &draw) {
+        uint32_t frames = DrawUtils::getFrameCount();
+        uint64_t timeUs = DrawUtils::getDrawTimeUs();
+        for (uint32_t i = 0; i < rounds; i++) {
+            draw();
+        }
+        frames = DrawUtils::getFrameCount() - frames;
+        return frames > 0 ? (double) (DrawUtils::getDrawTimeUs() - timeUs) / frames : 0;
+    }
+
+private:
+    void initBuffers() {
+        uint32_t tvSize  = DrawUtils::getBufferSize(SCREEN_TV);
+        uint32_t drcSize = DrawUtils::getBufferSize(SCREEN_DRC);
+        DrawUtils::initBuffers(mBuffer, tvSize, (uint8_t *) mBuffer + tvSize, drcSize);
+    }
+
+    void *mBuffer = nullptr;
+    bool mValid   = false;
+};
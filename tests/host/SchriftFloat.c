@@ -0,0 +1,17 @@
+/* schrift.c built with SFT_USE_FLOAT next to the default build. Its external functions get an sftf_ prefix, the
+ * public types don't depend on the precision. See SchriftFloat.h. */
+#define SFT_USE_FLOAT
+#define reallocarray   sftf_reallocarray
+#define sft_version    sftf_version
+#define sft_uses_float sftf_uses_float
+#define sft_loadmem    sftf_loadmem
+#define sft_loadmem_ex sftf_loadmem_ex
+#define sft_freefont   sftf_freefont
+#define sft_lmetrics   sftf_lmetrics
+#define sft_lookup     sftf_lookup
+#define sft_gmetrics   sftf_gmetrics
+#define sft_kerning    sftf_kerning
+#define sft_render     sftf_render
+#define sft_render_sdf sftf_render_sdf
+
+#include "schrift.c"
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "schrift.h"
+
+/**
+ * The rasterizer built with SFT_USE_FLOAT, see SchriftFloat.c. Fonts loaded by one build can't be used with the other.
+ */
+extern "C" {
+int sftf_uses_float(void);
+SFT_Font *sftf_loadmem(const void *mem, size_t size);
+void sftf_freefont(SFT_Font *font);
+int sftf_lookup(const SFT *sft, SFT_UChar codepoint, SFT_Glyph *glyph);
+int sftf_gmetrics(const SFT *sft, SFT_Glyph glyph, SFT_GMetrics *metrics);
+int sftf_render(const SFT *sft, SFT_Glyph glyph, SFT_Image image);
+}
@@ -0,0 +1,356 @@
+// Host implementations of the wut, libmocha and main.cpp symbols the menus use, so they can run headless with the
+// memory backend of DrawUtils. Nothing is connected: the controllers never deliver samples, no title or disc
+// exists and every file system call to the console's storage fails.
+//
+// The clock runs in real time, but sleeping advances it instead of blocking. A frame that is faster than the frame
+// rate ends as soon as it's drawn, the menus still see the same number of ticks per frame as on the console.
+// Logs go to stderr if HOST_LOG is set.
+
+#include <atomic>
+#include <chrono>
+#include <coreinit/cache.h>
+#include <coreinit/core.h>
+#include <coreinit/debug.h>
+#include <coreinit/filesystem_fsa.h>
+#include <coreinit/im.h>
+#include <coreinit/mcp.h>
+#include <coreinit/memory.h>
+#include <coreinit/savedframe.h>
+#include <coreinit/screen.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <gx2/display.h>
+#include <gx2/state.h>
+#include <mocha/mocha.h>
+#include <nn/ccr/sys.h>
+#include <padscore/kpad.h>
+#include <sndcore2/core.h>
+#include <sysapp/title.h>
+#include <thread>
+#include <vector>
+#include <vpad/input.h>
+#include <whb/log.h>
+
+#define HOST_FONT_PATH "fonts/Lato-Regular.ttf"
+
+// defined by main.cpp on the console
+bool gUpdatesBlocked = false;
+
+static const auto clockStart = std::chrono::steady_clock::now();
+static std::atomic<OSTime> sleptTicks{0};
+
+static void vlog(const char *fmt, va_list args) {
+    static const bool enabled = getenv("HOST_LOG") != nullptr;
+    if (enabled) {
+        vfprintf(stderr, fmt, args);
+    }
+}
+
+struct HostThread {
+    OSThreadEntryPointFn entry;
+    int32_t argc;
+    char *argv;
+    int result;
+    std::atomic<bool> terminated;
+    std::thread thread;
+};
+
+extern "C" {
+
+OSTime OSGetTime(void) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - clockStart);
+    // start at a minute after boot, nothing should treat a time of 0 as valid
+    return OSSecondsToTicks(60) + OSMicrosecondsToTicks(elapsed.count()) + sleptTicks.load(std::memory_order_relaxed);
+}
+
+OSTime OSGetSystemTime(void) {
+    return OSGetTime();
+}
+
+OSTick OSGetTick(void) {
+    return (OSTick) OSGetTime();
+}
+
+void OSSleepTicks(OSTime ticks) {
+    if (ticks > 0) {
+        sleptTicks.fetch_add(ticks, std::memory_order_relaxed);
+    }
+    std::this_thread::yield();
+}
+
+void OSYieldThread(void) {
+    std::this_thread::yield();
+}
+
+BOOL OSCreateThread(OSThread *thread, OSThreadEntryPointFn entry, int32_t argc, char *argv, void *, uint32_t, int32_t, OSThreadAttributes) {
+    auto *host = new HostThread();
+    host->entry = entry;
+    host->argc  = argc;
+    host->argv  = argv;
+    host->terminated.store(false);
+    thread->host = host;
+    return TRUE;
+}
+
+BOOL OSResumeThread(OSThread *thread) {
+    auto *host   = (HostThread *) thread->host;
+    host->thread = std::thread([host]() {
+        host->result = host->entry(host->argc, (const char **) host->argv);
+        host->terminated.store(true, std::memory_order_release);
+    });
+    return TRUE;
+}
+
+BOOL OSJoinThread(OSThread *thread, int *threadResult) {
+    auto *host = (HostThread *) thread->host;
+    if (host->thread.joinable()) {
+        host->thread.join();
+    }
+    if (threadResult) {
+        *threadResult = host->result;
+    }
+    delete host;
+    thread->host = nullptr;
+    return TRUE;
+}
+
+BOOL OSIsThreadTerminated(OSThread *thread) {
+    return ((HostThread *) thread->host)->terminated.load(std::memory_order_acquire);
+}
+
+void OSSetThreadName(OSThread *, const char *) {
+}
+
+uint32_t OSGetCoreId(void) {
+    return 1;
+}
+
+void OSReport(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vlog(fmt, args);
+    va_end(args);
+}
+
+void OSFatal(const char *msg) {
+    fprintf(stderr, "OSFatal: %s\n", msg);
+    abort();
+}
+
+int WHBLogPrintf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vlog(fmt, args);
+    va_end(args);
+    OSReport("\n");
+    return 0;
+}
+
+int WHBLogWritef(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vlog(fmt, args);
+    va_end(args);
+    return 0;
+}
+
+void DCFlushRange(void *, uint32_t) {
+}
+
+void OSMemoryBarrier(void) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+BOOL OSGetSharedData(OSSharedDataType, uint32_t, void **outPtr, uint32_t *outSize) {
+    static std::vector<uint8_t> font;
+    if (font.empty()) {
+        FILE *f = fopen(HOST_FONT_PATH, "rb");
+        if (!f) {
+            return FALSE;
+        }
+        fseek(f, 0, SEEK_END);
+        font.resize(ftell(f));
+        fseek(f, 0, SEEK_SET);
+        size_t read = fread(font.data(), 1, font.size(), f);
+        fclose(f);
+        if (read != font.size()) {
+            font.clear();
+            return FALSE;
+        }
+    }
+    *outPtr  = font.data();
+    *outSize = font.size();
+    return TRUE;
+}
+
+void __OSClearSavedFrame(OSSavedFrame, OSSavedFrameScreen) {
+}
+
+void OSScreenInit(void) {
+}
+
+uint32_t OSScreenGetBufferSizeEx(OSScreenID screen) {
+    return screen == SCREEN_TV ? 1280 * 720 * 4 * 2 : 896 * 480 * 4 * 2;
+}
+
+void OSScreenSetBufferEx(OSScreenID, void *) {
+}
+
+uint32_t OSScreenEnableEx(OSScreenID, BOOL) {
+    return 0;
+}
+
+void OSScreenClearBufferEx(OSScreenID, uint32_t) {
+}
+
+void OSScreenFlipBuffersEx(OSScreenID) {
+}
+
+void OSScreenPutPixelEx(OSScreenID, uint32_t, uint32_t, uint32_t) {
+}
+
+void GX2SetTVEnable(BOOL) {
+}
+
+void GX2SetDRCEnable(BOOL) {
+}
+
+void GX2Init(uint32_t *) {
+}
+
+void GX2Shutdown(void) {
+}
+
+int32_t GX2GetMainCoreId(void) {
+    return 1;
+}
+
+IOSHandle IM_Open(void) {
+    return 1;
+}
+
+IOSError IM_Close(IOSHandle) {
+    return IOS_ERROR_OK;
+}
+
+IOSError IM_GetEventNotify(IOSHandle, IMRequest *, IMEventMask *, IOSAsyncCallbackFn, void *) {
+    return IOS_ERROR_OK;
+}
+
+IOSError IM_CancelGetEventNotify(IOSHandle, IMRequest *, IOSAsyncCallbackFn, void *) {
+    return IOS_ERROR_OK;
+}
+
+void CCRSysInit(void) {
+}
+
+void CCRSysExit(void) {
+}
+
+int32_t CCRSysGetPincode(uint32_t *pin) {
+    *pin = 0;
+    return -1;
+}
+
+int32_t CCRSysStartPairing(uint32_t, uint32_t) {
+    return -1;
+}
+
+int32_t CCRSysStopPairing(void) {
+    return 0;
+}
+
+CCRSysPairingState CCRSysGetPairingState(void) {
+    return CCR_SYS_PAIRING_TIMED_OUT;
+}
+
+void KPADInit(void) {
+}
+
+void KPADShutdown(void) {
+}
+
+int32_t KPADReadEx(KPADChan, KPADStatus *, uint32_t, KPADError *error) {
+    *error = KPAD_ERROR_NO_SAMPLES;
+    return 0;
+}
+
+KPADConnectCallback KPADSetConnectCallback(KPADChan, KPADConnectCallback) {
+    return nullptr;
+}
+
+KPADSamplingCallback KPADSetSamplingCallback(KPADChan, KPADSamplingCallback) {
+    return nullptr;
+}
+
+int32_t WPADProbe(WPADChan, WPADExtensionType *) {
+    return -1;
+}
+
+BOOL WPADStartSyncDevice(void) {
+    return FALSE;
+}
+
+void WPADEnableURCC(BOOL) {
+}
+
+int32_t VPADRead(VPADChan, VPADStatus *, uint32_t, VPADReadError *outError) {
+    *outError = VPAD_READ_NO_SAMPLES;
+    return 0;
+}
+
+VPADSamplingCallback VPADSetSamplingCallback(VPADChan, VPADSamplingCallback) {
+    return nullptr;
+}
+
+void AXInit(void) {
+}
+
+BOOL AXIsInit(void) {
+    return FALSE;
+}
+
+BOOL SYSCheckTitleExists(uint64_t) {
+    return FALSE;
+}
+
+int32_t MCP_Open(void) {
+    return -1;
+}
+
+int32_t MCP_Close(int32_t) {
+    return 0;
+}
+
+int32_t MCP_TitleListByDeviceType(int32_t, MCPDeviceType, uint32_t *outTitleCount, MCPTitleListType *, uint32_t) {
+    *outTitleCount = 0;
+    return -1;
+}
+
+FSAClientHandle FSAAddClient(void *) {
+    return -1;
+}
+
+FSError FSADelClient(FSAClientHandle) {
+    return FS_ERROR_OK;
+}
+
+FSError FSAMakeDir(FSAClientHandle, const char *, FSMode) {
+    return FS_ERROR_NOT_FOUND;
+}
+
+FSError FSAOpenFileEx(FSAClientHandle, const char *, const char *, FSMode, FSOpenFileFlags, uint32_t, FSAFileHandle *) {
+    return FS_ERROR_NOT_FOUND;
+}
+
+FSError FSARemove(FSAClientHandle, const char *) {
+    return FS_ERROR_NOT_FOUND;
+}
+
+MochaUtilsStatus Mocha_UnlockFSClientEx(FSAClientHandle) {
+    return MOCHA_RESULT_LIB_UNINITIALIZED;
+}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Stand-in for wut's coreinit/cache.h on the host.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void DCFlushRange(void *addr, uint32_t size);
+
+void OSMemoryBarrier(void);
+
+#ifdef __cplusplus
+}
+#endif
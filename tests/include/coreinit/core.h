@@ -0,0 +1,15 @@
+#pragma once
+
+// Stand-in for wut's coreinit/core.h on the host.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t OSGetCoreId(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+// Stand-in for wut's coreinit/debug.h on the host.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void OSReport(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+void OSFatal(const char *msg) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
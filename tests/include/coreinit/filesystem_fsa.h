@@ -0,0 +1,40 @@
+#pragma once
+
+// Stand-in for wut's coreinit/filesystem_fsa.h on the host. There is no MLC, every call fails.
+
+#include <wut_types.h>
+
+typedef int32_t FSAClientHandle;
+typedef uint32_t FSAFileHandle;
+
+typedef enum FSError {
+    FS_ERROR_OK            = 0,
+    FS_ERROR_NOT_FOUND     = -0x30006,
+} FSError;
+
+typedef enum FSMode {
+    FS_MODE_READ_OWNER  = 0x400,
+    FS_MODE_WRITE_OWNER = 0x200,
+} FSMode;
+
+typedef enum FSOpenFileFlags {
+    FS_OPEN_FLAG_NONE = 0,
+} FSOpenFileFlags;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+FSAClientHandle FSAAddClient(void *attachParams);
+
+FSError FSADelClient(FSAClientHandle client);
+
+FSError FSAMakeDir(FSAClientHandle client, const char *path, FSMode mode);
+
+FSError FSAOpenFileEx(FSAClientHandle client, const char *path, const char *mode, FSMode createMode, FSOpenFileFlags openFlag, uint32_t preallocSize, FSAFileHandle *outFileHandle);
+
+FSError FSARemove(FSAClientHandle client, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
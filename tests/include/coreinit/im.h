@@ -0,0 +1,29 @@
+#pragma once
+
+// Stand-in for wut's coreinit/im.h on the host. No event ever arrives.
+
+#include <coreinit/ios.h>
+
+typedef struct IMRequest {
+    uint8_t unknown[0x80];
+} IMRequest;
+
+typedef uint32_t IMEventMask;
+
+#define IM_EVENT_SYNC 0x400
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+IOSHandle IM_Open(void);
+
+IOSError IM_Close(IOSHandle handle);
+
+IOSError IM_GetEventNotify(IOSHandle handle, IMRequest *request, IMEventMask *event, IOSAsyncCallbackFn asyncCallback, void *asyncCallbackContext);
+
+IOSError IM_CancelGetEventNotify(IOSHandle handle, IMRequest *request, IOSAsyncCallbackFn asyncCallback, void *asyncCallbackContext);
+
+#ifdef __cplusplus
+}
+#endif
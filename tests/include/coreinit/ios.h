@@ -0,0 +1,13 @@
+#pragma once
+
+// Stand-in for wut's coreinit/ios.h on the host.
+
+#include <wut_types.h>
+
+typedef int32_t IOSHandle;
+
+typedef enum IOSError {
+    IOS_ERROR_OK = 0,
+} IOSError;
+
+typedef void (*IOSAsyncCallbackFn)(IOSError status, void *context);
@@ -0,0 +1,28 @@
+#pragma once
+
+// Stand-in for wut's coreinit/mcp.h on the host. There is no disc drive.
+
+#include <wut_types.h>
+
+typedef enum MCPDeviceType {
+    MCP_DEVICE_TYPE_ODD = 1,
+} MCPDeviceType;
+
+typedef struct MCPTitleListType {
+    uint64_t titleId;
+    uint8_t unknown[0x5c];
+} MCPTitleListType;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t MCP_Open(void);
+
+int32_t MCP_Close(int32_t handle);
+
+int32_t MCP_TitleListByDeviceType(int32_t handle, MCPDeviceType deviceType, uint32_t *outTitleCount, MCPTitleListType *titleList, uint32_t titleListSizeBytes);
+
+#ifdef __cplusplus
+}
+#endif
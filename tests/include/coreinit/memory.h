@@ -0,0 +1,22 @@
+#pragma once
+
+// Stand-in for wut's coreinit/memory.h on the host. The shared font is the test font, see host/WutStubs.cpp.
+
+#include <wut_types.h>
+
+typedef enum OSSharedDataType {
+    OS_SHAREDDATATYPE_FONT_CHINESE  = 0,
+    OS_SHAREDDATATYPE_FONT_KOREAN   = 1,
+    OS_SHAREDDATATYPE_FONT_STANDARD = 2,
+    OS_SHAREDDATATYPE_FONT_TAIWANESE = 3,
+} OSSharedDataType;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BOOL OSGetSharedData(OSSharedDataType type, uint32_t unk_r4, void **outPtr, uint32_t *outSize);
+
+#ifdef __cplusplus
+}
+#endif
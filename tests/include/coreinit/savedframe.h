@@ -0,0 +1,25 @@
+#pragma once
+
+// Stand-in for wut's coreinit/savedframe.h on the host.
+
+#include <wut_types.h>
+
+typedef enum OSSavedFrame {
+    OS_SAVED_FRAME_A = 0,
+    OS_SAVED_FRAME_B = 1,
+} OSSavedFrame;
+
+typedef enum OSSavedFrameScreen {
+    OS_SAVED_FRAME_SCREEN_TV  = 0,
+    OS_SAVED_FRAME_SCREEN_DRC = 1,
+} OSSavedFrameScreen;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void __OSClearSavedFrame(OSSavedFrame frame, OSSavedFrameScreen screen);
+
+#ifdef __cplusplus
+}
+#endif
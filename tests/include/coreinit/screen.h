@@ -0,0 +1,33 @@
+#pragma once
+
+// Stand-in for wut's coreinit/screen.h on the host. Host runs use the memory backend of DrawUtils, so none of
+// these draw anything.
+
+#include <wut_types.h>
+
+typedef enum OSScreenID {
+    SCREEN_TV  = 0,
+    SCREEN_DRC = 1,
+} OSScreenID;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void OSScreenInit(void);
+
+uint32_t OSScreenGetBufferSizeEx(OSScreenID screen);
+
+void OSScreenSetBufferEx(OSScreenID screen, void *addr);
+
+uint32_t OSScreenEnableEx(OSScreenID screen, BOOL enable);
+
+void OSScreenClearBufferEx(OSScreenID screen, uint32_t color);
+
+void OSScreenFlipBuffersEx(OSScreenID screen);
+
+void OSScreenPutPixelEx(OSScreenID screen, uint32_t x, uint32_t y, uint32_t color);
+
+#ifdef __cplusplus
+}
+#endif
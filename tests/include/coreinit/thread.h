@@ -0,0 +1,44 @@
+#pragma once
+
+// Stand-in for wut's coreinit/thread.h on the host, threads run on std::thread.
+
+#include <coreinit/time.h>
+
+typedef int (*OSThreadEntryPointFn)(int argc, const char **argv);
+
+typedef struct OSThread {
+    // the host thread, see host/WutStubs.cpp
+    void *host;
+} OSThread;
+
+typedef uint8_t OSThreadAttributes;
+
+enum OS_THREAD_ATTRIB {
+    OS_THREAD_ATTRIB_AFFINITY_CPU0 = 1 << 0,
+    OS_THREAD_ATTRIB_AFFINITY_CPU1 = 1 << 1,
+    OS_THREAD_ATTRIB_AFFINITY_CPU2 = 1 << 2,
+    OS_THREAD_ATTRIB_AFFINITY_ANY  = 7,
+    OS_THREAD_ATTRIB_DETACHED      = 1 << 3,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BOOL OSCreateThread(OSThread *thread, OSThreadEntryPointFn entry, int32_t argc, char *argv, void *stack, uint32_t stackSize, int32_t priority, OSThreadAttributes attributes);
+
+BOOL OSResumeThread(OSThread *thread);
+
+BOOL OSJoinThread(OSThread *thread, int *threadResult);
+
+BOOL OSIsThreadTerminated(OSThread *thread);
+
+void OSSetThreadName(OSThread *thread, const char *name);
+
+void OSSleepTicks(OSTime ticks);
+
+void OSYieldThread(void);
+
+#ifdef __cplusplus
+}
+#endif
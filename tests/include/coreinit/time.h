@@ -0,0 +1,33 @@
+#pragma once
+
+// Stand-in for wut's coreinit/time.h on the host. The clock runs at the speed of the console's timer, see
+// host/WutStubs.cpp for how it advances.
+
+#include <wut_types.h>
+
+typedef int64_t OSTime;
+typedef int32_t OSTick;
+
+#define OSTimerClockSpeed                 62156250ll
+
+#define OSTicksToSeconds(val)             ((val) / OSTimerClockSpeed)
+#define OSTicksToMilliseconds(val)        (((val) * 1000ll) / OSTimerClockSpeed)
+#define OSTicksToMicroseconds(val)        (((val) * 1000000ll) / OSTimerClockSpeed)
+#define OSSecondsToTicks(val)             ((int64_t) (val) * OSTimerClockSpeed)
+#define OSMillisecondsToTicks(val)        (((int64_t) (val) * OSTimerClockSpeed) / 1000ll)
+#define OSMicrosecondsToTicks(val)        (((int64_t) (val) * OSTimerClockSpeed) / 1000000ll)
+#define OSNanosecondsToTicks(val)         (((int64_t) (val) * (OSTimerClockSpeed / 31250ll)) / 32000ll)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OSTime OSGetTime(void);
+
+OSTime OSGetSystemTime(void);
+
+OSTick OSGetTick(void);
+
+#ifdef __cplusplus
+}
+#endif
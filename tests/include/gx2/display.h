@@ -0,0 +1,17 @@
+#pragma once
+
+// Stand-in for wut's gx2/display.h on the host.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void GX2SetTVEnable(BOOL enable);
+
+void GX2SetDRCEnable(BOOL enable);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+// Stand-in for wut's gx2/state.h on the host.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void GX2Init(uint32_t *attributes);
+
+void GX2Shutdown(void);
+
+int32_t GX2GetMainCoreId(void);
+
+#ifdef __cplusplus
+}
+#endif
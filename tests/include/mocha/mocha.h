@@ -0,0 +1,20 @@
+#pragma once
+
+// Stand-in for libmocha's mocha/mocha.h on the host.
+
+#include <coreinit/filesystem_fsa.h>
+
+typedef enum MochaUtilsStatus {
+    MOCHA_RESULT_SUCCESS         = 0,
+    MOCHA_RESULT_LIB_UNINITIALIZED = -0x10,
+} MochaUtilsStatus;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+MochaUtilsStatus Mocha_UnlockFSClientEx(FSAClientHandle client);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+// Stand-in for wut's nn/act.h on the host, only the types of the account info.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+
+namespace nn::act {
+    typedef uint8_t SlotNo;
+
+    static constexpr size_t AccountIdSize = 17;
+    static constexpr size_t MiiNameSize   = 11;
+} // namespace nn::act
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+// Stand-in for wut's nn/ccr/sys.h on the host. Pairing never finishes.
+
+#include <wut_types.h>
+
+typedef enum CCRSysPairingState {
+    CCR_SYS_PAIRING_FINISHED    = 0,
+    CCR_SYS_PAIRING_IN_PROGRESS = 1,
+    CCR_SYS_PAIRING_TIMED_OUT   = 2,
+} CCRSysPairingState;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void CCRSysInit(void);
+
+void CCRSysExit(void);
+
+int32_t CCRSysGetPincode(uint32_t *pin);
+
+int32_t CCRSysStartPairing(uint32_t drcSlot, uint32_t timeout);
+
+int32_t CCRSysStopPairing(void);
+
+CCRSysPairingState CCRSysGetPairingState(void);
+
+#ifdef __cplusplus
+}
+#endif
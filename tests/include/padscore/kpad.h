@@ -0,0 +1,76 @@
+#pragma once
+
+// Stand-in for wut's padscore/kpad.h on the host. The layout of KPADStatus only has to match where the fields
+// are read.
+
+#include <padscore/wpad.h>
+
+typedef WPADChan KPADChan;
+
+typedef enum KPADError {
+    KPAD_ERROR_OK                 = 0,
+    KPAD_ERROR_NO_SAMPLES         = -1,
+    KPAD_ERROR_INVALID_CONTROLLER = -2,
+    KPAD_ERROR_UNINITIALIZED      = -5,
+} KPADError;
+
+typedef struct KPADVec2D {
+    float x;
+    float y;
+} KPADVec2D;
+
+typedef struct KPADStatus {
+    uint32_t hold;
+    uint32_t trigger;
+    uint32_t release;
+    uint8_t unknown[0x5c - 0x0c];
+    uint8_t extensionType;
+    int8_t error;
+    uint8_t unknown2[2];
+    union {
+        struct {
+            KPADVec2D stick;
+        } nunchuk;
+        struct {
+            uint32_t hold;
+            uint32_t trigger;
+            uint32_t release;
+            KPADVec2D leftStick;
+            KPADVec2D rightStick;
+            float leftTrigger;
+            float rightTrigger;
+        } classic;
+        struct {
+            uint32_t hold;
+            uint32_t trigger;
+            uint32_t release;
+            KPADVec2D leftStick;
+            KPADVec2D rightStick;
+            int32_t charging;
+            int32_t wired;
+        } pro;
+    };
+} KPADStatus;
+
+typedef void (*KPADConnectCallback)(KPADChan chan, int32_t status);
+typedef void (*KPADSamplingCallback)(KPADChan chan);
+
+#define KPAD_MAX_READ_BUFS 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void KPADInit(void);
+
+void KPADShutdown(void);
+
+int32_t KPADReadEx(KPADChan chan, KPADStatus *data, uint32_t size, KPADError *error);
+
+KPADConnectCallback KPADSetConnectCallback(KPADChan chan, KPADConnectCallback callback);
+
+KPADSamplingCallback KPADSetSamplingCallback(KPADChan chan, KPADSamplingCallback callback);
+
+#ifdef __cplusplus
+}
+#endif
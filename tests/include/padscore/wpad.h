@@ -0,0 +1,91 @@
+#pragma once
+
+// Stand-in for wut's padscore/wpad.h on the host. No controller is ever connected.
+
+#include <wut_types.h>
+
+typedef enum WPADChan {
+    WPAD_CHAN_0 = 0,
+    WPAD_CHAN_1 = 1,
+    WPAD_CHAN_2 = 2,
+    WPAD_CHAN_3 = 3,
+} WPADChan;
+
+typedef enum WPADExtensionType {
+    WPAD_EXT_CORE           = 0,
+    WPAD_EXT_NUNCHUK        = 1,
+    WPAD_EXT_CLASSIC        = 2,
+    WPAD_EXT_MPLUS          = 5,
+    WPAD_EXT_MPLUS_NUNCHUK  = 6,
+    WPAD_EXT_MPLUS_CLASSIC  = 7,
+    WPAD_EXT_PRO_CONTROLLER = 31,
+} WPADExtensionType;
+
+typedef enum WPADButton {
+    WPAD_BUTTON_LEFT  = 0x0001,
+    WPAD_BUTTON_RIGHT = 0x0002,
+    WPAD_BUTTON_DOWN  = 0x0004,
+    WPAD_BUTTON_UP    = 0x0008,
+    WPAD_BUTTON_PLUS  = 0x0010,
+    WPAD_BUTTON_2     = 0x0100,
+    WPAD_BUTTON_1     = 0x0200,
+    WPAD_BUTTON_B     = 0x0400,
+    WPAD_BUTTON_A     = 0x0800,
+    WPAD_BUTTON_MINUS = 0x1000,
+    WPAD_BUTTON_Z     = 0x2000,
+    WPAD_BUTTON_C     = 0x4000,
+    WPAD_BUTTON_HOME  = 0x8000,
+} WPADButton;
+
+typedef enum WPADClassicButton {
+    WPAD_CLASSIC_BUTTON_UP    = 0x0001,
+    WPAD_CLASSIC_BUTTON_LEFT  = 0x0002,
+    WPAD_CLASSIC_BUTTON_ZR    = 0x0004,
+    WPAD_CLASSIC_BUTTON_X     = 0x0008,
+    WPAD_CLASSIC_BUTTON_A     = 0x0010,
+    WPAD_CLASSIC_BUTTON_Y     = 0x0020,
+    WPAD_CLASSIC_BUTTON_B     = 0x0040,
+    WPAD_CLASSIC_BUTTON_ZL    = 0x0080,
+    WPAD_CLASSIC_BUTTON_R     = 0x0200,
+    WPAD_CLASSIC_BUTTON_PLUS  = 0x0400,
+    WPAD_CLASSIC_BUTTON_HOME  = 0x0800,
+    WPAD_CLASSIC_BUTTON_MINUS = 0x1000,
+    WPAD_CLASSIC_BUTTON_L     = 0x2000,
+    WPAD_CLASSIC_BUTTON_DOWN  = 0x4000,
+    WPAD_CLASSIC_BUTTON_RIGHT = 0x8000,
+} WPADClassicButton;
+
+typedef enum WPADProButton {
+    WPAD_PRO_BUTTON_UP      = 0x00001,
+    WPAD_PRO_BUTTON_LEFT    = 0x00002,
+    WPAD_PRO_TRIGGER_ZR     = 0x00004,
+    WPAD_PRO_BUTTON_X       = 0x00008,
+    WPAD_PRO_BUTTON_A       = 0x00010,
+    WPAD_PRO_BUTTON_Y       = 0x00020,
+    WPAD_PRO_BUTTON_B       = 0x00040,
+    WPAD_PRO_TRIGGER_ZL     = 0x00080,
+    WPAD_PRO_RESERVED       = 0x00100,
+    WPAD_PRO_TRIGGER_R      = 0x00200,
+    WPAD_PRO_BUTTON_PLUS    = 0x00400,
+    WPAD_PRO_BUTTON_HOME    = 0x00800,
+    WPAD_PRO_BUTTON_MINUS   = 0x01000,
+    WPAD_PRO_TRIGGER_L      = 0x02000,
+    WPAD_PRO_BUTTON_DOWN    = 0x04000,
+    WPAD_PRO_BUTTON_RIGHT   = 0x08000,
+    WPAD_PRO_BUTTON_STICK_R = 0x10000,
+    WPAD_PRO_BUTTON_STICK_L = 0x20000,
+} WPADProButton;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t WPADProbe(WPADChan chan, WPADExtensionType *outExtensionType);
+
+BOOL WPADStartSyncDevice(void);
+
+void WPADEnableURCC(BOOL enable);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+// Stand-in for wut's sndcore2/core.h on the host.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void AXInit(void);
+
+BOOL AXIsInit(void);
+
+#ifdef __cplusplus
+}
+#endif
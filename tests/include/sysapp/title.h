@@ -0,0 +1,15 @@
+#pragma once
+
+// Stand-in for wut's sysapp/title.h on the host. No title is installed.
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BOOL SYSCheckTitleExists(uint64_t titleId);
+
+#ifdef __cplusplus
+}
+#endif
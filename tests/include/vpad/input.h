@@ -0,0 +1,67 @@
+#pragma once
+
+// Stand-in for wut's vpad/input.h on the host. The GamePad never delivers a sample.
+
+#include <wut_types.h>
+
+typedef enum VPADChan {
+    VPAD_CHAN_0 = 0,
+    VPAD_CHAN_1 = 1,
+} VPADChan;
+
+typedef enum VPADButtons {
+    VPAD_BUTTON_A       = 0x8000,
+    VPAD_BUTTON_B       = 0x4000,
+    VPAD_BUTTON_X       = 0x2000,
+    VPAD_BUTTON_Y       = 0x1000,
+    VPAD_BUTTON_LEFT    = 0x0800,
+    VPAD_BUTTON_RIGHT   = 0x0400,
+    VPAD_BUTTON_UP      = 0x0200,
+    VPAD_BUTTON_DOWN    = 0x0100,
+    VPAD_BUTTON_ZL      = 0x0080,
+    VPAD_BUTTON_ZR      = 0x0040,
+    VPAD_BUTTON_L       = 0x0020,
+    VPAD_BUTTON_R       = 0x0010,
+    VPAD_BUTTON_PLUS    = 0x0008,
+    VPAD_BUTTON_MINUS   = 0x0004,
+    VPAD_BUTTON_HOME    = 0x0002,
+    VPAD_BUTTON_SYNC    = 0x0001,
+    VPAD_BUTTON_STICK_R = 0x00020000,
+    VPAD_BUTTON_STICK_L = 0x00040000,
+    VPAD_BUTTON_TV      = 0x00010000,
+} VPADButtons;
+
+typedef enum VPADReadError {
+    VPAD_READ_SUCCESS            = 0,
+    VPAD_READ_NO_SAMPLES         = -1,
+    VPAD_READ_INVALID_CONTROLLER = -2,
+    VPAD_READ_UNINITIALIZED      = -5,
+} VPADReadError;
+
+typedef struct VPADVec2D {
+    float x;
+    float y;
+} VPADVec2D;
+
+typedef struct VPADStatus {
+    uint32_t hold;
+    uint32_t trigger;
+    uint32_t release;
+    VPADVec2D leftStick;
+    VPADVec2D rightStick;
+    uint8_t unknown[0xac - 0x1c];
+} VPADStatus;
+
+typedef void (*VPADSamplingCallback)(VPADChan chan);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t VPADRead(VPADChan chan, VPADStatus *buffers, uint32_t count, VPADReadError *outError);
+
+VPADSamplingCallback VPADSetSamplingCallback(VPADChan chan, VPADSamplingCallback callback);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+// Stand-in for wut's whb/log.h on the host.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int WHBLogPrintf(const char *fmt, ...);
+
+int WHBLogWritef(const char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,11 @@
+#pragma once
+
+// Stand-in for wut's wut_types.h on the host, only what the host tests use.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int32_t BOOL;
+
+#define TRUE  1
+#define FALSE 0